@@ -1,10 +1,16 @@
 #include "Ast.hpp"
+#include "LangData.hpp"
 #include <stdlib.h>
+#include <algorithm>
 
 namespace LangBase {
 // Code generation
 void AstEnum::generateDefinition(string *str, LData *langData) {
-    *str += "enum " + name + " {\n    ";
+    *str += "enum " + name;
+    if (langData->options.compactLayout) {
+        *str += " : " + underlyingType();
+    }
+    *str += " {\n    ";
     bool isFirst = true;
     for (string member : members) {
         if (!isFirst) *str += ", ";
@@ -13,6 +19,9 @@ void AstEnum::generateDefinition(string *str, LData *langData) {
     }
     *str += "\n};\n";
 }
+string AstEnum::underlyingType() {
+    return (members.size() <= 256) ? "uint8_t" : "uint16_t";
+}
 void AstEnum::generateToStringMethod(string *str, LData *langData) {
     *str += "static std::string enum" + name + "ToString(" + name + " item) {\n";
     *str += "    switch (item) {\n";
@@ -23,11 +32,94 @@ void AstEnum::generateToStringMethod(string *str, LData *langData) {
     *str += "    default: return \"\";\n";
     *str += "    }\n}\n";
 }
+void AstEnum::generateLengthMethod(string *str, LData *langData) {
+    *str += "static size_t enum" + name + "Length(" + name + " item) {\n";
+    *str += "    switch (item) {\n";
+    for (string member : members) {
+        *str += "    case " + member + ":";
+        *str += "return " + std::to_string(values[member].size()) + ";\n";
+    }
+    *str += "    default: return 0;\n";
+    *str += "    }\n}\n";
+}
 void AstClassMember::generateMember(string *str, LData *langData, AstClass *astClass) {
     *str += "    ";
-    typedPart->generateGrammarType(str, langData);
+    generateMemberType(str, langData);
     *str += " " + typedPart->getMemberKey() + ";\n";
 }
+// Same as grammar type, except for inline lists
+// which are held by value, taking over parser lists
+void AstClassMember::generateMemberType(string *str, LData *langData) {
+    if (typedPart->type == PLIST && langData->options.inlineListSlots > 0) {
+        *str += "NodeList<";
+        static_cast<TypedPartList*>(typedPart)->type->generateGrammarType(str, langData);
+        *str += ">";
+    } else {
+        typedPart->generateGrammarType(str, langData);
+    }
+}
+// Assumed alignment of the member type, used to
+// order members. Pointers and strings are taken as 8.
+size_t AstClassMember::alignment(LData *langData) {
+    switch (typedPart->type) {
+        case PINT:
+        return (static_cast<TypedPartPrim*>(typedPart)->intType == "int") ? 4 : 8;
+        case PENUM: {
+            TypedPartEnum *enumPart = static_cast<TypedPartEnum*>(typedPart);
+            if (langData->enums.count(enumPart->enumKey) > 0 &&
+                langData->enums[enumPart->enumKey]->underlyingType() == "uint8_t") {
+                return 1;
+            }
+            return 2;
+        }
+        default:
+        return 8;
+    }
+}
+string AstClassMember::getSetterName() {
+    string memberKey = typedPart->getMemberKey();
+    memberKey[0] = std::toupper(memberKey[0]);
+    return "set" + memberKey;
+}
+void AstClassMember::generateSetterDecl(string *str, LData *langData, AstClass *astClass) {
+    *str += "    void " + getSetterName() + "(";
+    typedPart->generateGrammarType(str, langData);
+    *str += " " + typedPart->getMemberKey() + ");\n";
+}
+// Defined after all classes, as child
+// types need to be complete
+void AstClassMember::generateSetterDefinition(string *str, LData *langData, AstClass *astClass) {
+    string memberKey = typedPart->getMemberKey();
+    *str += "inline void " + astClass->identifier + "::" + getSetterName() + "(";
+    typedPart->generateGrammarType(str, langData);
+    *str += " " + memberKey + ") {\n";
+    if (typedPart->type == PSTRING) {
+        *str += "    this->" + memberKey + " = std::move(" + memberKey + ");\n";
+    } else {
+        *str += "    this->" + memberKey + " = " + memberKey + ";\n";
+    }
+    if (typedPart->type == PAST) {
+        *str += "    if (" + memberKey + " != nullptr) " + memberKey + "->parent = this;\n";
+    } else if (typedPart->type == PLIST) {
+        TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+        if (listType->type->type == PAST && langData->options.inlineListSlots > 0) {
+            // Parser list is taken over by the node list
+            *str += "    for (AstNode *child : this->" + memberKey + ") child->parent = this;\n";
+        } else if (listType->type->type == PAST) {
+            *str += "    if (" + memberKey + " != nullptr) {\n";
+            *str += "        for (AstNode *child : *" + memberKey + ") child->parent = this;\n";
+            *str += "    }\n";
+        }
+    }
+    *str += "    markDirty();\n";
+    if (langData->options.hasMemoHash()) {
+        *str += "    clearHash();\n";
+    }
+    if (langData->options.lossless) {
+        *str += "    markEdited();\n";
+    }
+    *str += "}\n";
+}
 void AstClassConstructor::generateConstructor(string *str, LData *langData, AstClass *astClass) {
     *str += "    ";
     *str += astClass->identifier + "(";
@@ -56,11 +148,11 @@ void AstClassConstructor::generateConstructor(string *str, LData *langData, AstC
     }
     // Initialize in same order as members
     vector<int> order;
-    for (auto const &pair : astClass->members) {
+    for (string const &memberKey : astClass->memberOrder(langData)) {
         // Check for arg, and add to order vector
         // if found
         for (size_t i = 0; i < numArgs; ++i) {
-            if (args[i] == pair.first) {
+            if (args[i] == memberKey) {
                 order.push_back(i);
                 break;
             }
@@ -73,21 +165,62 @@ void AstClassConstructor::generateConstructor(string *str, LData *langData, AstC
     for (size_t i = 0; i < numArgs; ++i) {
         *str += ", ";
         string arg = args[order[i]];
-        *str += arg + "(" + arg + ")";
+        // Strings are taken by value and moved
+        if (astClass->members[arg]->typedPart->type == PSTRING) {
+            *str += arg + "(std::move(" + arg + "))";
+        } else {
+            *str += arg + "(" + arg + ")";
+        }
     }
     *str += " {}\n";
 }
+// Declaration order of members. Key order, or with
+// compactLayout, by decreasing alignment to avoid padding
+vector<string> AstClass::memberOrder(LData *langData) {
+    vector<string> order;
+    for (auto const &member : members) {
+        order.push_back(member.first);
+    }
+    if (langData->options.compactLayout) {
+        std::stable_sort(order.begin(), order.end(), [this, langData](const string &a, const string &b) {
+            return members[a]->alignment(langData) > members[b]->alignment(langData);
+        });
+    }
+    return order;
+}
 void AstClass::generateHeader(string *str, LData *langData) {
     *str += "class " + identifier;
     if (extends != "") *str += " : public " + extends;
     else *str += " : public AstNode";
     *str += " {\npublic:\n";
-    for (auto const &member : members) {
-        member.second->generateMember(str, langData, this);
+    for (string const &memberKey : memberOrder(langData)) {
+        members[memberKey]->generateMember(str, langData, this);
     }
     for (AstClassConstructor *constr : constructors) {
         constr->generateConstructor(str, langData, this);
     }
+    if (langData->options.renderCache) {
+        for (auto const &member : members) {
+            member.second->generateSetterDecl(str, langData, this);
+        }
+    }
+    if (langData->options.hasEmptyConstructor()) {
+        // Empty node for deserializer to fill,
+        // unless a rule gives one
+        bool hasEmpty = false;
+        for (AstClassConstructor *constr : constructors) {
+            if (constr->args.size() == 0) hasEmpty = true;
+        }
+        if (constructors.size() > 0 && !hasEmpty) {
+            *str += "    " + identifier + "() : ";
+            if (extends != "") {
+                *str += extends + "(" + identifier + "Node)";
+            } else {
+                *str += "AstNode(" + identifier + "Node)";
+            }
+            *str += " {}\n";
+        }
+    }
     if (subClasses.size() > 0) {
         // Generate constructor with node type
         *str += "    " + identifier + "(NodeType nodeType) : ";
@@ -100,7 +233,24 @@ void AstClass::generateHeader(string *str, LData *langData) {
     }
     *str += "};\n";
 }
+// Fails compilation when the class is larger than
+// its base and members with only the end padding
+void AstClass::generateLayoutCheck(string *str, LData *langData) {
+    string bound = "sizeof(" + ((extends != "") ? extends : "AstNode") + ")";
+    for (auto const &member : members) {
+        bound += " + sizeof(";
+        member.second->generateMemberType(&bound, langData);
+        bound += ")";
+    }
+    string align = "alignof(" + identifier + ")";
+    *str += "static_assert(sizeof(" + identifier + ") <= (" + bound + " + " + align + " - 1) / " + align + " * " + align;
+    *str += ", \"" + identifier + " has padding\");\n";
+}
 void AstClass::generateDefinition(string *str, LData *langData) {
-
+    if (langData->options.renderCache) {
+        for (auto const &member : members) {
+            member.second->generateSetterDefinition(str, langData, this);
+        }
+    }
 }
 }
\ No newline at end of file
@@ -37,6 +37,8 @@ public:
     AstEnum(string name) : name(name) {}
     void generateDefinition(string *str, LData *langData);
     void generateToStringMethod(string *str, LData *langData);
+    void generateLengthMethod(string *str, LData *langData);
+    string underlyingType();
 };
 
 /**
@@ -47,6 +49,11 @@ public:
     TypedPart *typedPart;
     AstClassMember(TypedPart *typedPart) : typedPart(typedPart) {}
     void generateMember(string *str, LData *langData, AstClass *astClass);
+    void generateMemberType(string *str, LData *langData);
+    string getSetterName();
+    void generateSetterDecl(string *str, LData *langData, AstClass *astClass);
+    void generateSetterDefinition(string *str, LData *langData, AstClass *astClass);
+    size_t alignment(LData *langData);
 };
 
 /**
@@ -78,7 +85,9 @@ public:
             // Verify type
         }
     }
+    vector<string> memberOrder(LData *langData);
     void generateHeader(string *str, LData *langData);
     void generateDefinition(string *str, LData *langData);
+    void generateLayoutCheck(string *str, LData *langData);
 };
 }
\ No newline at end of file
@@ -24,7 +24,9 @@ enum TokenType {
     NONE,
     TSTRING,
     TINT,
-    TFLOAT
+    TFLOAT,
+    TINT64,
+    TUINT64
 };
 
 class DescrNode {
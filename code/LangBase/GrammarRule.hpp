@@ -112,7 +112,8 @@ public:
     bool sepBetween;
     // List of rules. Empty on shorthand form
     vector<ListRuleDef*> ruleDefs;
-    ListGrammarType(string key) : GrammarType(key) {}
+    ListGrammarType(string key)
+        : GrammarType(key), type(nullptr), sep(nullptr), sepBetween(false) {}
 };
 
 /**
@@ -13,7 +13,20 @@ TokenData* LData::getBuiltInToken(string identifier) {
     if (identifier == "SEMICOLON") return new TokenData(NONE, "SEMICOLON", "\\;");
     if (identifier == "EQUAL") return new TokenData(NONE, "EQUAL", "\\=");
     if (identifier == "intConst") return new TokenData(TINT, "intConst", "[1-9][0-9]*");
-    if (identifier == "identifier") return new TokenData(TSTRING, "identifier", "[_a-zA-Z][0-9_a-zA-Z]*");
+    if (identifier == "identifier") {
+        if (options.utf8) {
+            // Any non-ASCII character but whitespace, taken as
+            // opaque bytes. Input is validated separately.
+            string nonAscii = "(\\xC2[\\x80-\\x84\\x86-\\x9F\\xA1-\\xBF]|[\\xC3-\\xDF][\\x80-\\xBF]"
+                "|[\\xE0\\xE4-\\xEF][\\x80-\\xBF]{2}"
+                "|\\xE1([\\x80-\\x99\\x9B-\\xBF][\\x80-\\xBF]|\\x9A[\\x81-\\xBF])"
+                "|\\xE2([\\x82-\\xBF][\\x80-\\xBF]|\\x80[\\x8B-\\xA7\\xAA-\\xAE\\xB0-\\xBF]|\\x81[\\x80-\\x9E\\xA0-\\xBF])"
+                "|\\xE3([\\x81-\\xBF][\\x80-\\xBF]|\\x80[\\x81-\\xBF])"
+                "|[\\xF0-\\xF4][\\x80-\\xBF]{3})";
+            return new TokenData(TSTRING, "identifier", "([_a-zA-Z]|" + nonAscii + ")([0-9_a-zA-Z]|" + nonAscii + ")*");
+        }
+        return new TokenData(TSTRING, "identifier", "[_a-zA-Z][0-9_a-zA-Z]*");
+    }
     // Whitespace token
     // Not added to rules currently
     // Used when whitespace is needed in ToString source
@@ -89,6 +102,12 @@ TypedPart* LData::getTypedPart(string identifier) {
             case TFLOAT:
             return new TypedPartPrim(PFLOAT, tokenRef->key);
             break;
+            case TINT64:
+            return new TypedPartPrim(PINT, tokenRef->key, "int64_t");
+            break;
+            case TUINT64:
+            return new TypedPartPrim(PINT, tokenRef->key, "uint64_t");
+            break;
         }
     } else if (enumGrammarTypes.count(identifier) != 0) {
         EnumGrammarType *enumData = enumGrammarTypes[identifier];
@@ -111,6 +130,57 @@ TypedPart* LData::getTypedPart(string identifier) {
         return nullptr;
     }
 }
+uint64_t LData::grammarFingerprint() {
+    // Canonical description, maps give stable order
+    string descr = langKey + "\n";
+    for (auto const &pair : tokenData) {
+        descr += "token " + pair.first + " " + std::to_string(pair.second->type) + " " + pair.second->regex + "\n";
+    }
+    vector<GrammarType*> grammars;
+    for (auto const &pair : astGrammarTypes) grammars.push_back(pair.second);
+    for (auto const &pair : listGrammarTypes) grammars.push_back(pair.second);
+    for (auto const &pair : enumGrammarTypes) grammars.push_back(pair.second);
+    for (GrammarType *grammar : grammars) {
+        descr += "grammar " + grammar->key + "\n";
+        for (GrammarRule *rule : grammar->rules) {
+            for (string token : rule->tokenList) descr += " " + token;
+            descr += "\n";
+        }
+    }
+    for (auto const &pair : astClasses) {
+        descr += "class " + pair.first + " " + pair.second->extends + "\n";
+        for (auto const &member : pair.second->members) {
+            descr += " " + member.first + " ";
+            member.second->typedPart->generateGrammarType(&descr, this);
+            descr += "\n";
+        }
+    }
+    for (auto const &pair : enums) {
+        descr += "enum " + pair.first + "\n";
+        for (auto const &value : pair.second->values) {
+            descr += " " + value.first + " " + value.second + "\n";
+        }
+    }
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : descr) {
+        hash ^= (unsigned char)c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+bool LData::isSpillList(string listKey) {
+    if (!options.spill) return false;
+    TypedPart *startPart = startAction->startPart;
+    if (startPart->type == PLIST) return startKey == listKey;
+    if (startPart->type != PAST) return false;
+    AstClass *startClass = astClasses[static_cast<TypedPartAst*>(startPart)->astClass];
+    for (auto const &member : startClass->members) {
+        TypedPart *typedPart = member.second->typedPart;
+        if (typedPart->type == PLIST && typedPart->identifier == listKey) return true;
+    }
+    return false;
+}
 string LData::keyFromTypeDecl(TypeDecl *typeDecl) {
     return (typeDecl->alias.compare("") != 0) ? typeDecl->alias : typeDecl->identifier;
 }
@@ -3,6 +3,7 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <stdint.h>
 #include "DescrNode.hpp"
 #include "GrammarRule.hpp"
 #include "Ast.hpp"
@@ -34,6 +35,152 @@ public:
         return key + "_T";
     }
 };
+/**
+ * Optional features of the generated code.
+ * Everything is off by default, giving the
+ * plain ast classes, visitor and ToSource.
+ */
+class GenOptions {
+public:
+    // Index of nodes per NodeType, filled
+    // by the construction actions while parsing
+    bool nodeIndex;
+    // Nodes carry a bitmask of the NodeTypes
+    // found in their subtree
+    bool subtreeMask;
+    // ToSource writes through a buffered SourceSink
+    // instead of appending to one string
+    bool toSourceSink;
+    // ToSource gets a measure pass, and renders
+    // into a buffer of the exact size
+    bool toSourceMeasure;
+    // ToSource renders large lists on worker threads
+    bool toSourceParallel;
+    // Nodes cache their rendered source, with setters
+    // marking the path to the root dirty
+    bool renderCache;
+    // Binary serializer and deserializer
+    // for ast trees
+    bool serializer;
+    // Relocatable snapshot format, read in
+    // place through generated views
+    bool snapshot;
+    // Cache of serialized trees keyed on hash
+    // of input and grammar. Implies serializer.
+    bool parseCache;
+    // Structural hash() and equals() on nodes
+    bool structuralHash;
+    // Hashes stored in nodes, computed bottom up
+    // by construction actions. Implies structuralHash.
+    bool memoHash;
+    // Construction actions return an existing equal
+    // node when one was built in the same parse.
+    // Implies memoHash. Can't be used with locations.
+    bool hashCons;
+    // Members ordered by alignment, sized enums,
+    // padding checks and a node size report
+    bool compactLayout;
+    // Byte offsets of each node in the source,
+    // with line and column resolved on demand
+    bool locations;
+    // Lexer counts byte offsets only, without yylineno.
+    // Lines are found from a newline index on errors.
+    // Implies locations.
+    bool offsetsOnly;
+    // Lexer input is validated as UTF-8 while read.
+    // Identifiers accept non-ASCII characters as opaque
+    // UTF-8 bytes, without XID classes, while non-ASCII
+    // whitespace such as U+00A0 and U+2028 is skipped.
+    bool utf8;
+    // Lexer converts numbers with std::from_chars,
+    // and reports out of range values. Needs C++17.
+    bool fromChars;
+    // String tokens are passed from the lexer as
+    // std::string and moved into nodes
+    bool moveStrings;
+    // When above zero, list members are NodeLists
+    // with this many elements stored in the node
+    size_t inlineListSlots;
+    // Struct of arrays copy of trees, one table per
+    // class, with children as 32 bit NodeIds
+    bool columns;
+    // Lexer keeps tokens and trivia of the source,
+    // and ToSource splices it for unchanged nodes.
+    // Nodes know their parent.
+    bool lossless;
+    // Parser appends flat postorder events instead of
+    // allocating nodes, which are materialized on demand
+    bool lazyNodes;
+    // Generated destroyTree() deleting nodes and lists
+    // below a root, iteratively
+    bool destroyTree;
+    // Generated clone() copying subtrees through an
+    // allocator, with a bump allocating NodeArena
+    bool cloneTree;
+    // Nodes are shared between versions, and changed
+    // through path copying withX() helpers
+    bool persistentNodes;
+    // Finished items of lists held by the start node
+    // are written to a snapshot file while parsing
+    bool spill;
+    GenOptions() : nodeIndex(false), subtreeMask(false), toSourceSink(false),
+                   toSourceMeasure(false), toSourceParallel(false), renderCache(false),
+                   serializer(false), snapshot(false), parseCache(false),
+                   structuralHash(false), memoHash(false), hashCons(false),
+                   compactLayout(false), locations(false),
+                   offsetsOnly(false), utf8(false),
+                   fromChars(false), moveStrings(false),
+                   inlineListSlots(0), columns(false),
+                   lossless(false), lazyNodes(false),
+                   destroyTree(false), cloneTree(false),
+                   persistentNodes(false), spill(false) {}
+    // Construction actions pass new nodes
+    // through a generated finishNode()
+    bool hasFinishNode() {
+        // Lazy nodes get parents when materialized
+        return nodeIndex || subtreeMask || renderCache || hasMemoHash() ||
+               (lossless && !lazyNodes);
+    }
+    bool hasStructuralHash() {
+        return structuralHash || hasMemoHash();
+    }
+    bool hasLocations() {
+        return locations || offsetsOnly || lossless || lazyNodes;
+    }
+    // Classes get a constructor without args,
+    // for nodes filled member by member
+    bool hasEmptyConstructor() {
+        return hasSerializer() || lazyNodes || hasShallowClone();
+    }
+    bool hasSnapshot() {
+        return snapshot || spill;
+    }
+    bool hasDestroyTree() {
+        return destroyTree || spill || hasSerializer();
+    }
+    bool hasShallowClone() {
+        return cloneTree || persistentNodes;
+    }
+    bool hasMemoHash() {
+        return memoHash || hashCons;
+    }
+    // Nodes know their parent
+    bool hasParent() {
+        return renderCache || lossless;
+    }
+    bool hasSerializer() {
+        return serializer || parseCache;
+    }
+    // Generated forEachChild and findPath functions
+    bool hasChildIteration() {
+        return hasParent() || persistentNodes || hasMemoHash();
+    }
+    // ToSource writes through out() rather
+    // than appending to str
+    bool hasToSourceOut() {
+        return toSourceSink || toSourceMeasure;
+    }
+};
 /**
  * Central object for lang data.
  */
@@ -52,7 +199,9 @@ public:
     map<string, map<string, vector<string>>> serializedTokenLists;
     string startKey;
     StartAction *startAction;
+    GenOptions options;
     LData(string langKey) : langKey(langKey) {}
+    LData(string langKey, GenOptions options) : langKey(langKey), options(options) {}
     // Some built in tokens provided
     // from identifier
     // Returns nullptr when not found.
@@ -69,6 +218,13 @@ public:
     // if equal.
     AstClass* ensureSubRelation(string baseClass, string subClass);
     TypedPart* getTypedPart(string identifier);
+    // Hash of tokens, rules, classes and enums,
+    // changing whenever the generated parser
+    // or node layout would.
+    uint64_t grammarFingerprint();
+    // List grammar whose items are spilled, being
+    // the start list or a list of the start class
+    bool isSpillList(string listKey);
     string keyFromTypeDecl(TypeDecl *typeDecl);
     string serializeTokenList(vector<string> tokenList) {
         // Simple serialization (readable, could also check for uniqueness)
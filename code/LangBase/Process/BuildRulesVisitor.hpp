@@ -72,6 +72,7 @@ public:
         }
         ListPushAction *pushAction = new ListPushAction(1, innerAction, pushType, grammar->type);
         pushAction->innerAction = innerAction;
+        pushAction->listKey = grammar->key;
         return pushAction;
     }
 
@@ -123,6 +124,8 @@ public:
             rule->serialized
         );
         astAction->typed = new TypedPartAst(ruleDef->astClass, ruleDef->astClass);
+        astAction->firstNum = startNum + 1;
+        astAction->lastNum = num;
         return astAction;
     }
 
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <fstream>
 #include <array>
+#include <algorithm>
 
 extern FILE *yyin;
 extern int yyparse();
@@ -43,10 +44,64 @@ public:
                 "   #define __strdup _strdup\n"
                 "#else\n"
                 "   #define __strdup strdup\n"
-                "#endif\n"
-                "%}\n"
-                "%option yylineno\n"
-                "%%\n";
+                "#endif\n";
+        if (langData->options.utf8 || langData->options.lossless) {
+            str +=  "#include \"" + langData->langKey + ".hpp\"\n";
+        }
+        if (langData->options.lossless) {
+            str +=  "SyntaxTree syntaxTree;\n"
+                    "// Marks the token added by YY_USER_ACTION\n"
+                    "static int syntaxToken(int kind) {\n"
+                    "    syntaxTree.tokens.back().kind = kind;\n"
+                    "    return kind;\n"
+                    "}\n";
+        }
+        if (langData->options.utf8) {
+            // Validates each buffer as flex reads it
+            str +=  "Utf8Validator utf8Input;\n"
+                    "#define YY_INPUT(buf, result, max_size) {\\\n"
+                    "    size_t len = fread(buf, 1, max_size, yyin);\\\n"
+                    "    if (!utf8Input.feed(buf, len) || (len == 0 && !utf8Input.finish())) {\\\n"
+                    "        printf(\"Invalid UTF-8 at offset %lu\", (unsigned long)utf8Input.errorOffset);\\\n"
+                    "        exit(1);\\\n"
+                    "    }\\\n"
+                    "    result = len;\\\n"
+                    "}\n";
+        }
+        if (langData->options.hasLocations()) {
+            // Runs before every rule action, including
+            // the default rule for unmatched bytes
+            str +=  "uint32_t lexOffset = 0;\n"
+                    "#define YY_USER_ACTION yylloc.start = lexOffset; lexOffset += yyleng; yylloc.end = lexOffset;";
+            if (langData->options.lossless) {
+                // Added as trivia, tokens set their kind
+                str += " syntaxTree.add(yytext, yyleng);";
+            }
+            str += "\n";
+        }
+        if (langData->options.fromChars) {
+            // Locale independent, and fails instead
+            // of wrapping on overflow
+            str +=  "#include <charconv>\n"
+                    "template<typename T>\n"
+                    "static T parseNumber(const char *text, size_t len) {\n"
+                    "    T val = 0;\n"
+                    "    auto res = std::from_chars(text, text + len, val);\n"
+                    "    if (res.ec != std::errc() || res.ptr != text + len) {\n"
+                    "        printf(\"Invalid number %s\\n\", text);\n"
+                    "        exit(1);\n"
+                    "    }\n"
+                    "    return val;\n"
+                    "}\n";
+        }
+        str +=  "%}\n";
+        if (!langData->options.offsetsOnly) {
+            str += "%option yylineno\n";
+        }
+        if (langData->options.utf8) {
+            str += "%option 8bit\n";
+        }
+        str +=  "%%\n";
         for (auto const &pair : langData->tokenData) {
             TokenData *token = pair.second;
             if (token->key == "WS") {
@@ -54,26 +109,61 @@ public:
                 // in source code
                 continue;
             }
+            string ret = tokenReturn(token);
             switch (token->type) {
                 case NONE:
-                str += token->regex + " { return " + token->getGrammarToken() + "; }\n";
+                str += token->regex + " { " + ret + " }\n";
                 break;
                 case TINT:
-                str += token->regex + " { yylval.ival = atoi(yytext); return " + token->getGrammarToken() + "; }\n";
+                str += token->regex + " { yylval.ival = " + numberConversion("int", "atoi(yytext)") + "; " + ret + " }\n";
                 break;
                 case TSTRING:
-                str += token->regex + " { yylval.sval = __strdup(yytext); return " + token->getGrammarToken() + "; }\n";
+                if (langData->options.moveStrings) {
+                    str += token->regex + " { yylval.sval = new std::string(yytext, yyleng); " + ret + " }\n";
+                } else {
+                    str += token->regex + " { yylval.sval = __strdup(yytext); " + ret + " }\n";
+                }
                 break;
                 case TFLOAT:
-                str += token->regex + " { yylval.fval = atof(yytext); return " + token->getGrammarToken() + "; }\n";
+                str += token->regex + " { yylval.fval = " + numberConversion("double", "atof(yytext)") + "; " + ret + " }\n";
+                break;
+                case TINT64:
+                str += token->regex + " { yylval.i64val = " + numberConversion("int64_t", "strtoll(yytext, nullptr, 10)") + "; " + ret + " }\n";
+                break;
+                case TUINT64:
+                str += token->regex + " { yylval.u64val = " + numberConversion("uint64_t", "strtoull(yytext, nullptr, 10)") + "; " + ret + " }\n";
                 break;
             }
         }
+        if (langData->options.utf8) {
+            // Non-ASCII White_Space, left out of identifiers
+            str +=  "(\\xC2[\\x85\\xA0]|\\xE1\\x9A\\x80|\\xE2\\x80[\\x80-\\x8A\\xA8\\xA9\\xAF]|\\xE2\\x81\\x9F|\\xE3\\x80\\x80)+ { }\n";
+        }
+        if (langData->options.lossless) {
+            // Whitespace and unmatched bytes are kept
+            // as trivia instead of echoed
+            str +=  "[ \\t\\r\\n]+ { }\n"
+                    ". { }\n";
+        }
         str +=  "%%\n"
                 "int yywrap() { return 1; }\n";
         saveToFile(&str, "gen/" + langData->langKey + ".l");
     }
     // Generate bison grammar
+    // Return statement of a token rule
+    string tokenReturn(TokenData *token) {
+        if (langData->options.lossless) {
+            return "return syntaxToken(" + token->getGrammarToken() + ");";
+        }
+        return "return " + token->getGrammarToken() + ";";
+    }
+    // Conversion of yytext to a number in lexer actions
+    string numberConversion(string type, string fallback) {
+        if (langData->options.fromChars) {
+            return "parseNumber<" + type + ">(yytext, yyleng)";
+        }
+        return fallback;
+    }
     void generateGrammarFile() {
         string str = "";
         str +=  "%{\n"
@@ -86,19 +176,91 @@ public:
         }
         langData->startAction->startPart->generateGrammarType(&str, langData);
         str += " result;\n";
+        if (langData->options.nodeIndex) {
+            // Set by Loader when an index is requested
+            str += "NodeIndex *nodeIndex = nullptr;\n";
+        }
+        if (langData->options.hashCons) {
+            // Set by Loader for the duration of a parse
+            str += "HashConsTable *hashCons = nullptr;\n";
+        }
+        if (langData->options.lazyNodes) {
+            // Set by Loader for the duration of a parse
+            str += "LazyTree *lazyTree = nullptr;\n";
+        }
+        if (langData->options.spill) {
+            // Set by Loader when spilling is requested
+            str += "SpillSink *spillSink = nullptr;\n";
+        }
         str +=  "extern FILE *yyin;\n"
                 "void yyerror(const char *s);\n"
-                "extern int yylex(void);\n"
-                "extern int yylineno;\n"
-                "%}\n";
+                "extern int yylex(void);\n";
+        if (langData->options.moveStrings) {
+            // Moves the lexed string out, and frees the holder
+            str += "static std::string takeString(std::string *val) {\n"
+                   "    std::string str = std::move(*val);\n"
+                   "    delete val;\n"
+                   "    return str;\n"
+                   "}\n";
+        }
+        if (!langData->options.offsetsOnly) {
+            str += "extern int yylineno;\n";
+        }
+        if (langData->options.hasLocations()) {
+            // Span from first to last symbol, empty
+            // rules are placed at end of previous symbol
+            str +=  "#define YYLLOC_DEFAULT(Cur, Rhs, N) do {\\\n"
+                    "    if (N) {\\\n"
+                    "        (Cur).start = YYRHSLOC(Rhs, 1).start;\\\n"
+                    "        (Cur).end = YYRHSLOC(Rhs, N).end;\\\n"
+                    "    } else {\\\n"
+                    "        (Cur).start = (Cur).end = YYRHSLOC(Rhs, 0).end;\\\n"
+                    "    }\\\n"
+                    "} while (0)\n";
+        }
+        str +=  "%}\n";
+        if (langData->options.hasLocations()) {
+            // Two offsets instead of line/column pairs
+            str +=  "%code requires {\n"
+                    "#include <stdint.h>\n"
+                    "typedef struct YYLTYPE {\n"
+                    "    uint32_t start;\n"
+                    "    uint32_t end;\n"
+                    "} YYLTYPE;\n"
+                    "#define YYLTYPE_IS_DECLARED 1\n"
+                    "}\n"
+                    "%locations\n";
+        }
+        if (langData->options.moveStrings) {
+            str += "%code requires {\n"
+                   "#include <string>\n"
+                   "}\n";
+        }
+        if (langData->tokenTypes.count(TINT64) > 0 || langData->tokenTypes.count(TUINT64) > 0) {
+            // Union and header need sized types
+            str += "%code requires {\n"
+                   "#include <stdint.h>\n"
+                   "}\n";
+        }
         // Union
         str +=  "%union {\n"
                 "   void *ptr;\n";
+        if (langData->options.lazyNodes) {
+            str += "    uint32_t event;\n";
+        }
         for (TokenType ttype : langData->tokenTypes) {
             switch (ttype) {
                 case TINT: str += "    int ival;\n"; break;
-                case TSTRING: str += "    char *sval;\n"; break;
+                case TSTRING:
+                if (langData->options.moveStrings) {
+                    str += "    std::string *sval;\n";
+                } else {
+                    str += "    char *sval;\n";
+                }
+                break;
                 case TFLOAT: str += "    double fval;\n"; break;
+                case TINT64: str += "    int64_t i64val;\n"; break;
+                case TUINT64: str += "    uint64_t u64val;\n"; break;
                 case NONE: break;
             }
         }
@@ -116,6 +278,8 @@ public:
                 case TINT: str += "%token <ival> " + token->getGrammarToken() + "\n"; break;
                 case TSTRING: str += "%token <sval> " + token->getGrammarToken() + "\n"; break;
                 case TFLOAT: str += "%token <fval> " + token->getGrammarToken() + "\n"; break;
+                case TINT64: str += "%token <i64val> " + token->getGrammarToken() + "\n"; break;
+                case TUINT64: str += "%token <u64val> " + token->getGrammarToken() + "\n"; break;
             }
         }
         // Types
@@ -128,9 +292,10 @@ public:
             }
             str += "\n";
         }
-        // Ast and list goes to ptr
+        // Ast and list goes to ptr, or
+        // event index with lazy nodes
         if (langData->astGrammarTypes.size() > 0 || langData->listGrammarTypes.size() > 0) {
-            str += "%type <ptr> ";
+            str += langData->options.lazyNodes ? "%type <event> " : "%type <ptr> ";
             str += "start ";
             for (auto const &pair : langData->astGrammarTypes) {
                 AstGrammarType *astGrammar = pair.second;
@@ -162,9 +327,17 @@ public:
         }
         str += "\n%%\n";
 
-        str += "void yyerror(const char *s) {\n"
-               "    printf(\"Parse error on line %d: %s\", yylineno, s);\n"
-               "}\n";
+        if (langData->options.offsetsOnly) {
+            // Index is only built when there is an error
+            str += "void yyerror(const char *s) {\n"
+                   "    SourcePosition pos = SourceLines::fromStream(yyin).position(yylloc.start);\n"
+                   "    printf(\"Parse error on line %u, column %u: %s\", pos.line, pos.column, s);\n"
+                   "}\n";
+        } else {
+            str += "void yyerror(const char *s) {\n"
+                   "    printf(\"Parse error on line %d: %s\", yylineno, s);\n"
+                   "}\n";
+        }
         saveToFile(&str, "gen/" + langData->langKey + ".y");
     }
 
@@ -184,9 +357,63 @@ public:
     void generateAstClasses() {
         string str = "#pragma once\n";
         str += "#include <string>\n";
+        str += "#include <utility>\n";
         str += "#include <vector>\n";
+        if (langData->options.subtreeMask || langData->options.hasStructuralHash() ||
+            langData->options.compactLayout || langData->options.hasLocations() ||
+            langData->options.utf8 || langData->options.inlineListSlots > 0) {
+            str += "#include <stdint.h>\n";
+        }
+        if (langData->options.compactLayout || langData->options.hasLocations()) {
+            str += "#include <stdio.h>\n";
+        }
+        if (langData->options.hasStructuralHash() || langData->options.hasLocations() ||
+            langData->options.utf8) {
+            str += "#include <string.h>\n";
+        }
+        if (langData->options.lossless && langData->startAction->startPart->type == PLIST) {
+            // The root node spans all of the source
+            printf("Lossless mode needs an ast start rule\n");
+            exit(1);
+        }
+        if (langData->options.lazyNodes && langData->options.hasFinishNode()) {
+            // No nodes exist while parsing
+            printf("Lazy nodes can't be combined with options using finishNode\n");
+            exit(1);
+        }
+        if (langData->options.spill) {
+            checkSpillOptions();
+        }
+        if (langData->options.persistentNodes) {
+            // Nodes have a parent in every version holding them
+            if (langData->options.hasParent()) {
+                printf("Persistent nodes can't be combined with render cache or lossless mode\n");
+                exit(1);
+            }
+            if (langData->options.hasDestroyTree()) {
+                printf("Persistent nodes are shared between versions, and can't use destroyTree\n");
+                exit(1);
+            }
+        }
+        if (langData->options.hashCons) {
+            if (langData->options.hasParent()) {
+                // Shared nodes have several parents
+                printf("Hash consing can't be combined with render cache or lossless mode\n");
+                exit(1);
+            }
+            if (langData->options.hasLocations()) {
+                // Shared nodes stand for several places in the source
+                printf("Hash consing can't be combined with locations\n");
+                exit(1);
+            }
+            str += "#include <unordered_set>\n";
+        }
         // Create enum with entries for each class
-        str +=  "enum NodeType {\n    ";
+        str +=  "enum NodeType ";
+        if (langData->options.compactLayout) {
+            str += (langData->astClasses.size() <= 256) ? ": uint8_t " : ": uint16_t ";
+        }
+        str +=  "{\n    ";
         bool isFirst = true;
         for (auto const &astClass : langData->astClasses) {
             if (!isFirst) str += ", ";
@@ -194,19 +421,36 @@ public:
             isFirst = false;
         }
         str += "\n};\n";
+        if (langData->options.nodeIndex || langData->options.subtreeMask) {
+            str += "static const int NodeTypeCount = " + std::to_string(langData->astClasses.size()) + ";\n";
+        }
+        if (langData->options.subtreeMask) {
+            generateNodeMaskType(&str);
+        }
         for (auto const &astEnum : langData->enums) {
             astEnum.second->generateDefinition(&str, langData);
         }
         for (auto const &astEnum : langData->enums) {
             astEnum.second->generateToStringMethod(&str, langData);
         }
-        // AstNode base class with nodeType
-        str +=  "class AstNode {\n"
-                "public:\n"
-                "    NodeType nodeType;\n"
-                "    AstNode(NodeType nodeType) : nodeType(nodeType) {}\n"
-                "    virtual ~AstNode() {}\n"
-                "};\n";
+        if (langData->options.toSourceMeasure) {
+            for (auto const &astEnum : langData->enums) {
+                astEnum.second->generateLengthMethod(&str, langData);
+            }
+        }
+        if (langData->options.hasSerializer() || langData->options.hasSnapshot()) {
+            char fingerprint[32];
+            snprintf(fingerprint, sizeof(fingerprint), "0x%016llxULL", (unsigned long long)langData->grammarFingerprint());
+            str += "// Changes with the grammar, older trees are rejected\n";
+            str += "static const uint64_t " + langData->langKey + "GrammarFingerprint = " + fingerprint + ";\n";
+        }
+        if (langData->options.utf8) {
+            generateUtf8(&str);
+        }
+        if (langData->options.inlineListSlots > 0) {
+            generateNodeList(&str);
+        }
+        generateAstNodeBase(&str);
         // Forward declare classes
         for (auto const &astClass : langData->astClasses) {
             str += "class " + astClass.first + ";\n";
@@ -217,6 +461,52 @@ public:
         for (auto const &astClass : langData->astClasses) {
             generateHeaderClass(&str, astClass.first, &addedClasses);
         }
+        for (auto const &astClass : langData->astClasses) {
+            astClass.second->generateDefinition(&str, langData);
+        }
+        if (langData->options.compactLayout) {
+            generateLayoutReport(&str);
+        }
+        if (langData->options.hasChildIteration()) {
+            generateChildIteration(&str);
+        }
+        if (langData->options.hasStructuralHash()) {
+            generateStructuralHash(&str);
+        }
+        if (langData->options.hasDestroyTree()) {
+            generateDestroyTree(&str);
+        }
+        if (langData->options.spill) {
+            generateSpillSink(&str);
+        }
+        if (langData->options.hasShallowClone()) {
+            generateShallowClone(&str);
+        }
+        if (langData->options.cloneTree) {
+            generateCloneTree(&str);
+        }
+        if (langData->options.subtreeMask) {
+            // Used by path copying
+            generateSubtreeMasks(&str);
+        }
+        if (langData->options.persistentNodes) {
+            generatePersistentNodes(&str);
+        }
+        if (langData->options.nodeIndex) {
+            generateNodeIndex(&str);
+        }
+        if (langData->options.hasFinishNode()) {
+            generateFinishNode(&str);
+        }
+        if (langData->options.hasLocations()) {
+            generateLocations(&str);
+        }
+        if (langData->options.lossless) {
+            generateSyntaxTree(&str);
+        }
+        if (langData->options.lazyNodes) {
+            generateLazyTree(&str);
+        }
         // Some externs, needed for parseFile
         str += "extern FILE *yyin;\n";
         str += "extern int yyparse();\n";
@@ -225,28 +515,1602 @@ public:
         langData->startAction->startPart->generateGrammarType(&str, langData);
         str += " result;\n";
         str += "class Loader {\npublic:\n";
-        str += "static ";
-        langData->startAction->startPart->generateGrammarType(&str, langData);
-        str += " parseFile(std::string fileName) {\n";
-        str +=  "   FILE *sourceFile;\n"
-                "   #ifdef _WIN32\n"
-                "   fopen_s(&sourceFile, fileName.c_str(), \"r\");\n"
-                "   #else\n"
-                "   sourceFile = fopen(fileName.c_str(), \"r\");\n"
-                "   #endif\n"
-                "   if (!sourceFile) {\n"
-                "       printf(\"Can't open file %s\", fileName.c_str());\n"
-                "       exit(1);\n"
-                "   }\n"
-                "   yyin = sourceFile;\n"
-                "   do {\n"
-                "       yyparse();\n"
-                "   } while (!feof(yyin));\n"
-                "   return result;\n"
-                "}\n";
+        bool lazy = langData->options.lazyNodes;
+        string fileOpen = "   FILE *sourceFile;\n"
+                          "   #ifdef _WIN32\n"
+                          "   fopen_s(&sourceFile, fileName.c_str(), \"r\");\n"
+                          "   #else\n"
+                          "   sourceFile = fopen(fileName.c_str(), \"r\");\n"
+                          "   #endif\n"
+                          "   if (!sourceFile) {\n"
+                          "       printf(\"Can't open file %s\", fileName.c_str());\n"
+                          "       exit(1);\n"
+                          "   }\n";
+        // Input already in memory, as read by the parse cache
+        string bytesOpen = "   FILE *sourceFile;\n"
+                           "   #ifdef _WIN32\n"
+                           "   sourceFile = tmpfile();\n"
+                           "   if (sourceFile) {\n"
+                           "       fwrite(data, 1, len, sourceFile);\n"
+                           "       rewind(sourceFile);\n"
+                           "   }\n"
+                           "   #else\n"
+                           "   sourceFile = fmemopen((void*)data, len, \"r\");\n"
+                           "   #endif\n"
+                           "   if (!sourceFile) {\n"
+                           "       printf(\"Can't read input\");\n"
+                           "       exit(1);\n"
+                           "   }\n";
+        bool parseBytes = langData->options.parseCache;
+        if (lazy) {
+            generateLoaderParse(&str, "static LazyTree* parseLazy(std::string fileName)", fileOpen, false);
+            generateMaterializeRoot(&str, "parseFile(std::string fileName)", "parseLazy(fileName)");
+            if (parseBytes) {
+                generateLoaderParse(&str, "static LazyTree* parseLazyBytes(const char *data, size_t len)", bytesOpen, true);
+                generateMaterializeRoot(&str, "parseBytes(const char *data, size_t len)", "parseLazyBytes(data, len)");
+            }
+        } else {
+            generateLoaderParse(&str, "static " + startType() + " parseFile(std::string fileName)", fileOpen, false);
+            if (parseBytes) {
+                generateLoaderParse(&str, "static " + startType() + " parseBytes(const char *data, size_t len)", bytesOpen, true);
+            }
+        }
+        if (langData->options.spill) {
+            // Parse while spilling top level list items
+            str += "static " + startType() + " parseFile(std::string fileName, SpillSink *sink) {\n"
+                   "   spillSink = sink;\n"
+                   "   auto root = parseFile(fileName);\n"
+                   "   spillSink = nullptr;\n"
+                   "   return root;\n"
+                   "}\n";
+        }
+        if (langData->options.nodeIndex) {
+            // Parse while filling given index
+            str += "static ";
+            langData->startAction->startPart->generateGrammarType(&str, langData);
+            str += " parseFile(std::string fileName, NodeIndex *index) {\n";
+            str +=  "   nodeIndex = index;\n"
+                    "   auto root = parseFile(fileName);\n"
+                    "   nodeIndex = nullptr;\n"
+                    "   return root;\n"
+                    "}\n";
+        }
         str += "};\n";
         saveToFile(&str, "gen/" + langData->langKey + ".hpp");
     }
+
+    // Loader function parsing the stream opened by
+    // openCode, returning the root or lazy tree
+    void generateLoaderParse(string *str, string signature, string openCode, bool closeInput) {
+        bool lazy = langData->options.lazyNodes;
+        *str += signature + " {\n" + openCode;
+        *str += "   yyin = sourceFile;\n";
+        if (langData->options.hasLocations()) {
+            *str += "   lexOffset = 0;\n";
+        }
+        if (langData->options.lossless) {
+            *str += "   syntaxTree = SyntaxTree();\n";
+        }
+        if (langData->options.utf8) {
+            *str += "   utf8Input = Utf8Validator();\n";
+        }
+        if (langData->options.hashCons) {
+            *str += "   HashConsTable table;\n"
+                    "   hashCons = &table;\n";
+        }
+        if (lazy) {
+            *str += "   lazyTree = new LazyTree();\n";
+        }
+        *str += "   do {\n"
+                "       yyparse();\n"
+                "   } while (!feof(yyin));\n";
+        if (closeInput) {
+            *str += "   fclose(sourceFile);\n";
+        }
+        if (langData->options.hashCons) {
+            *str += "   hashCons = nullptr;\n";
+        }
+        if (langData->options.lossless && lazy) {
+            // Root covers leading and trailing trivia
+            *str += "   if (lazyTree->root != 0) {\n"
+                    "       lazyTree->events[lazyTree->root].start = 0;\n"
+                    "       lazyTree->events[lazyTree->root].end = (uint32_t)syntaxTree.text.size();\n"
+                    "   }\n";
+        } else if (langData->options.lossless) {
+            *str += "   if (result != nullptr) {\n"
+                    "       result->startOffset = 0;\n"
+                    "       result->endOffset = (uint32_t)syntaxTree.text.size();\n"
+                    "   }\n";
+        }
+        if (lazy) {
+            *str += "   LazyTree *tree = lazyTree;\n"
+                    "   lazyTree = nullptr;\n"
+                    "   return tree;\n"
+                    "}\n";
+        } else {
+            *str += "   return result;\n"
+                    "}\n";
+        }
+    }
+    // Whole tree at once from a lazy parse,
+    // as without lazy nodes
+    void generateMaterializeRoot(string *str, string signature, string lazyCall) {
+        TypedPart *startPart = langData->startAction->startPart;
+        *str += "static " + startType() + " " + signature + " {\n"
+                "   LazyTree *tree = " + lazyCall + ";\n";
+        if (startPart->type == PLIST) {
+            string elemType;
+            static_cast<TypedPartList*>(startPart)->type->generateGrammarType(&elemType, langData);
+            *str += "   " + startType() + " root = tree->materializeList<" + elemType + ">(tree->root);\n";
+        } else {
+            *str += "   " + startType() + " root = static_cast<" + startType() + ">(tree->materialize(tree->root));\n";
+        }
+        *str += "   delete tree;\n"
+                "   return root;\n"
+                "}\n";
+    }
+
+    // List class of list members
+    string listClass(string elemType) {
+        if (langData->options.inlineListSlots > 0) {
+            return "NodeList<" + elemType + ">";
+        }
+        return "std::vector<" + elemType + ">";
+    }
+    // List member as a pointer
+    string listPtr(string owner, string memberKey) {
+        if (langData->options.inlineListSlots > 0) {
+            return "(&" + owner + "->" + memberKey + ")";
+        }
+        return owner + "->" + memberKey;
+    }
+    // Null check around code using a list member, returning
+    // the indent of the body. Inline lists are never null.
+    string openListPresent(string *str, string owner, string memberKey) {
+        if (langData->options.inlineListSlots > 0) {
+            return "    ";
+        }
+        *str += "    if (" + owner + "->" + memberKey + " != nullptr) {\n";
+        return "        ";
+    }
+    void closeListPresent(string *str) {
+        if (langData->options.inlineListSlots == 0) {
+            *str += "    }\n";
+        }
+    }
+
+    // Small vector for list members. Elements are
+    // stored in the node up to InlineListSlots.
+    void generateNodeList(string *str) {
+        if (langData->startAction->startPart->type == PLIST) {
+            // Root list is not held by a node
+            printf("Inline lists need an ast as start\n");
+            exit(1);
+        }
+        *str += "static const size_t InlineListSlots = " + std::to_string(langData->options.inlineListSlots) + ";\n"
+                "template<typename T>\n"
+                "class NodeList {\n"
+                "public:\n"
+                "    NodeList() : items(inlineItems), count(0), capacity(InlineListSlots) {}\n"
+                "    // Takes over a list built by the parser\n"
+                "    explicit NodeList(NodeList *list) : NodeList() {\n"
+                "        take(list);\n"
+                "    }\n"
+                "    explicit NodeList(std::vector<T> *list) : NodeList() {\n"
+                "        take(list);\n"
+                "    }\n"
+                "    NodeList(const NodeList&) = delete;\n"
+                "    NodeList& operator=(const NodeList&) = delete;\n"
+                "    NodeList& operator=(NodeList *list) {\n"
+                "        count = 0;\n"
+                "        take(list);\n"
+                "        return *this;\n"
+                "    }\n"
+                "    NodeList& operator=(std::vector<T> *list) {\n"
+                "        count = 0;\n"
+                "        take(list);\n"
+                "        return *this;\n"
+                "    }\n"
+                "    // List for the parser to fill, reused once taken\n"
+                "    // over so short lists need no allocation\n"
+                "    static NodeList* acquire() {\n"
+                "        std::vector<NodeList*> &lists = freeLists();\n"
+                "        if (lists.empty()) return new NodeList();\n"
+                "        NodeList *list = lists.back();\n"
+                "        lists.pop_back();\n"
+                "        return list;\n"
+                "    }\n"
+                "    ~NodeList() {\n"
+                "        if (items != inlineItems) delete[] items;\n"
+                "    }\n"
+                "    void push_back(T item) {\n"
+                "        if (count == capacity) grow(capacity * 2);\n"
+                "        items[count++] = item;\n"
+                "    }\n"
+                "    void reserve(size_t size) {\n"
+                "        if (size > capacity) grow(size);\n"
+                "    }\n"
+                "    void clear() { count = 0; }\n"
+                "    size_t size() const { return count; }\n"
+                "    bool empty() const { return count == 0; }\n"
+                "    T* begin() { return items; }\n"
+                "    T* end() { return items + count; }\n"
+                "    const T* begin() const { return items; }\n"
+                "    const T* end() const { return items + count; }\n"
+                "    T& front() { return items[0]; }\n"
+                "    T& back() { return items[count - 1]; }\n"
+                "    T& operator[](size_t i) { return items[i]; }\n"
+                "    const T& operator[](size_t i) const { return items[i]; }\n"
+                "private:\n"
+                "    // Points to inlineItems until grown\n"
+                "    T *items;\n"
+                "    uint32_t count;\n"
+                "    uint32_t capacity;\n"
+                "    T inlineItems[InlineListSlots];\n"
+                "    void grow(size_t size) {\n"
+                "        T *grown = new T[size];\n"
+                "        for (uint32_t i = 0; i < count; ++i) grown[i] = items[i];\n"
+                "        if (items != inlineItems) delete[] items;\n"
+                "        items = grown;\n"
+                "        capacity = (uint32_t)size;\n"
+                "    }\n"
+                "    void take(std::vector<T> *list) {\n"
+                "        if (list == nullptr) return;\n"
+                "        reserve(list->size());\n"
+                "        for (T item : *list) items[count++] = item;\n"
+                "        delete list;\n"
+                "    }\n"
+                "    // Grown buffers are moved, inline items copied\n"
+                "    void take(NodeList *list) {\n"
+                "        if (list == nullptr) return;\n"
+                "        if (list->items != list->inlineItems && items == inlineItems) {\n"
+                "            items = list->items;\n"
+                "            count = list->count;\n"
+                "            capacity = list->capacity;\n"
+                "            list->items = list->inlineItems;\n"
+                "            list->capacity = InlineListSlots;\n"
+                "        } else {\n"
+                "            reserve(list->count);\n"
+                "            for (uint32_t i = 0; i < list->count; ++i) items[count++] = list->items[i];\n"
+                "        }\n"
+                "        list->count = 0;\n"
+                "        freeLists().push_back(list);\n"
+                "    }\n"
+                "    // Parser state, like the rest of the parse\n"
+                "    static std::vector<NodeList*>& freeLists() {\n"
+                "        static std::vector<NodeList*> lists;\n"
+                "        return lists;\n"
+                "    }\n"
+                "};\n";
+    }
+
+    // Streaming UTF-8 validator, and identifier
+    // character classes matching the lexer rule
+    void generateUtf8(string *str) {
+        *str += "class Utf8Validator {\n"
+                "public:\n"
+                "    // Continuation bytes still expected, and\n"
+                "    // the allowed range of the next one\n"
+                "    int pending = 0;\n"
+                "    unsigned char low = 0x80;\n"
+                "    unsigned char high = 0xBF;\n"
+                "    size_t offset = 0;\n"
+                "    size_t errorOffset = 0;\n"
+                "    // Sequences may continue in the next call\n"
+                "    bool feed(const char *data, size_t size) {\n"
+                "        const unsigned char *bytes = (const unsigned char*)data;\n"
+                "        size_t i = 0;\n"
+                "        while (i < size) {\n"
+                "            if (pending == 0) {\n"
+                "                // ASCII eight bytes at a time\n"
+                "                uint64_t word;\n"
+                "                while (i + 8 <= size) {\n"
+                "                    memcpy(&word, bytes + i, 8);\n"
+                "                    if (word & 0x8080808080808080ULL) break;\n"
+                "                    i += 8;\n"
+                "                }\n"
+                "                if (i == size) break;\n"
+                "                unsigned char c = bytes[i];\n"
+                "                if (c < 0x80) { ++i; continue; }\n"
+                "                // Ranges exclude overlong forms, surrogates\n"
+                "                // and code points above U+10FFFF\n"
+                "                low = 0x80;\n"
+                "                high = 0xBF;\n"
+                "                if (c >= 0xC2 && c <= 0xDF) pending = 1;\n"
+                "                else if (c == 0xE0) { pending = 2; low = 0xA0; }\n"
+                "                else if (c == 0xED) { pending = 2; high = 0x9F; }\n"
+                "                else if (c >= 0xE1 && c <= 0xEF) pending = 2;\n"
+                "                else if (c == 0xF0) { pending = 3; low = 0x90; }\n"
+                "                else if (c >= 0xF1 && c <= 0xF3) pending = 3;\n"
+                "                else if (c == 0xF4) { pending = 3; high = 0x8F; }\n"
+                "                else return fail(i);\n"
+                "            } else {\n"
+                "                if (bytes[i] < low || bytes[i] > high) return fail(i);\n"
+                "                low = 0x80;\n"
+                "                high = 0xBF;\n"
+                "                --pending;\n"
+                "            }\n"
+                "            ++i;\n"
+                "        }\n"
+                "        offset += size;\n"
+                "        return true;\n"
+                "    }\n"
+                "    // At end of input\n"
+                "    bool finish() {\n"
+                "        if (pending != 0) return fail(0);\n"
+                "        return true;\n"
+                "    }\n"
+                "    bool fail(size_t i) {\n"
+                "        errorOffset = offset + i;\n"
+                "        return false;\n"
+                "    }\n"
+                "};\n"
+                "inline bool validUtf8(const char *data, size_t size) {\n"
+                "    Utf8Validator validator;\n"
+                "    return validator.feed(data, size) && validator.finish();\n"
+                "}\n";
+        // Bytes from 0x80 are parts of validated non-ASCII
+        // characters, whitespace is checked on decoding
+        *str += "enum CharClass : uint8_t {\n"
+                "    IdentStartChar = 1,\n"
+                "    IdentContinueChar = 2\n"
+                "};\n"
+                "static const uint8_t charClasses[256] = {";
+        for (int c = 0; c < 256; ++c) {
+            int cls = 0;
+            if (c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80) cls = 3;
+            else if (c >= '0' && c <= '9') cls = 2;
+            if (c % 32 == 0) *str += "\n    ";
+            *str += std::to_string(cls);
+            if (c < 255) *str += ",";
+        }
+        *str += "\n};\n"
+                "inline bool isIdentStart(unsigned char c) {\n"
+                "    return (charClasses[c] & IdentStartChar) != 0;\n"
+                "}\n"
+                "inline bool isIdentContinue(unsigned char c) {\n"
+                "    return (charClasses[c] & IdentContinueChar) != 0;\n"
+                "}\n"
+                "// Non-ASCII White_Space, lexed as whitespace\n"
+                "inline bool isNonAsciiSpace(uint32_t cp) {\n"
+                "    return cp == 0x85 || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A)\n"
+                "        || cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000;\n"
+                "}\n"
+                "// Valid UTF-8 which the identifier token would match\n"
+                "inline bool isIdentifier(const std::string &val) {\n"
+                "    if (val.empty() || !isIdentStart(val[0])) return false;\n"
+                "    for (size_t i = 1; i < val.size(); ++i) {\n"
+                "        if (!isIdentContinue(val[i])) return false;\n"
+                "    }\n"
+                "    if (!validUtf8(val.data(), val.size())) return false;\n"
+                "    for (size_t i = 0; i < val.size(); ++i) {\n"
+                "        unsigned char c = val[i];\n"
+                "        if (c < 0xC0) continue;\n"
+                "        size_t len = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : 1;\n"
+                "        uint32_t cp = c & (0x3F >> len);\n"
+                "        for (size_t j = 1; j <= len; ++j) cp = (cp << 6) | (val[i + j] & 0x3F);\n"
+                "        if (isNonAsciiSpace(cp)) return false;\n"
+                "        i += len;\n"
+                "    }\n"
+                "    return true;\n"
+                "}\n"
+                "extern Utf8Validator utf8Input;\n";
+    }
+
+    // Padding checks, and sizes of the node
+    // classes on the compiling platform
+    void generateLayoutReport(string *str) {
+        for (auto const &astClass : langData->astClasses) {
+            astClass.second->generateLayoutCheck(str, langData);
+        }
+        *str += "inline void printNodeSizes(FILE *out = stdout) {\n"
+                "    fprintf(out, \"AstNode %zu\\n\", sizeof(AstNode));\n";
+        for (auto const &astClass : langData->astClasses) {
+            *str += "    fprintf(out, \"" + astClass.first + " %zu\\n\", sizeof(" + astClass.first + "));\n";
+        }
+        *str += "}\n";
+    }
+
+    // AstNode base class with nodeType
+    void generateAstNodeBase(string *str) {
+        // Small fields are kept next to nodeType,
+        // after the vtable pointer
+        bool compact = langData->options.compactLayout;
+        bool updateMasks = langData->options.subtreeMask && langData->options.hasParent();
+        if (updateMasks || langData->options.renderCache) {
+            *str += "class AstNode;\n";
+        }
+        if (updateMasks) {
+            // Defined with the masks, used by markDirty
+            *str += "inline void updateSubtreeMasks(AstNode *node);\n";
+        }
+        if (langData->options.renderCache) {
+            // Children are kept by reference, so each
+            // node holds only its own text
+            *str += "// Text of a cached render, or a child whose\n"
+                    "// cached render goes in its place\n"
+                    "struct RenderPiece {\n"
+                    "    std::string text;\n"
+                    "    AstNode *child;\n"
+                    "};\n";
+        }
+        *str += "class AstNode {\n"
+                "public:\n"
+                "    NodeType nodeType;\n";
+        if (compact && langData->options.renderCache) {
+            *str += "    bool renderDirty = true;\n";
+        }
+        if (compact && langData->options.lossless) {
+            *str += "    bool edited = false;\n"
+                    "    bool editedBelow = false;\n";
+        }
+        if (langData->options.hasLocations()) {
+            // Byte offsets, end is exclusive
+            *str += "    uint32_t startOffset = 0;\n"
+                    "    uint32_t endOffset = 0;\n";
+        }
+        if (!compact && langData->options.lossless) {
+            // Rendered from the ast, or with descendants
+            // rendered from the ast. Offsets stay those
+            // of the source.
+            *str += "    bool edited = false;\n"
+                    "    bool editedBelow = false;\n";
+        }
+        if (langData->options.subtreeMask) {
+            // All bits set until finishNode has computed
+            // the mask, so hand built nodes are never skipped
+            *str += "    NodeMask subtreeMask;\n"
+                    "    AstNode(NodeType nodeType) : nodeType(nodeType), subtreeMask(~NodeMask(0)) {}\n";
+        } else {
+            *str += "    AstNode(NodeType nodeType) : nodeType(nodeType) {}\n";
+        }
+        if (langData->options.hasParent()) {
+            *str += "    AstNode *parent = nullptr;\n";
+        }
+        if (langData->options.renderCache) {
+            // Nodes start dirty, and are cleaned
+            // when rendered by ToSource
+            if (!compact) {
+                *str += "    bool renderDirty = true;\n";
+            }
+            *str += "    std::vector<RenderPiece> renderCache;\n";
+            if (updateMasks) {
+                *str += "    // Invalidates cached source and recomputes subtree\n"
+                        "    // masks up to the root. Call after changing a node\n"
+                        "    // other than by setters, as when adding to a list.\n";
+            } else {
+                *str += "    // Invalidates cached source up to the root.\n"
+                        "    // Call after changing a node other than by setters.\n";
+            }
+            *str += "    void markDirty() {\n"
+                    "        AstNode *node = this;\n"
+                    "        renderDirty = true;\n"
+                    "        while (node->parent != nullptr && !node->parent->renderDirty) {\n"
+                    "            node = node->parent;\n"
+                    "            node->renderDirty = true;\n"
+                    "        }\n";
+            if (updateMasks) {
+                *str += "        updateSubtreeMasks(this);\n";
+            }
+            *str += "    }\n";
+        }
+        if (langData->options.lossless) {
+            *str += "    // Node is rendered instead of taken from source, and\n"
+                    "    // ancestors splice it into theirs. Call after changing\n"
+                    "    // a node other than by setters.\n"
+                    "    void markEdited() {\n"
+                    "        AstNode *node = this;\n"
+                    "        edited = true;\n"
+                    "        while (node->parent != nullptr && !node->parent->editedBelow) {\n"
+                    "            node = node->parent;\n"
+                    "            node->editedBelow = true;\n"
+                    "        }\n"
+                    "    }\n";
+        }
+        if (langData->options.hasStructuralHash()) {
+            *str += "    uint64_t hash();\n"
+                    "    bool equals(AstNode *other);\n";
+        }
+        if (langData->options.hasMemoHash()) {
+            // Zero until computed
+            *str += "    uint64_t hashValue = 0;\n";
+            if (langData->options.hasParent()) {
+                *str += "    // Call after changing a node other than by setters\n"
+                        "    void clearHash() {\n"
+                        "        AstNode *node = this;\n"
+                        "        hashValue = 0;\n"
+                        "        while (node->parent != nullptr && node->parent->hashValue != 0) {\n"
+                        "            node = node->parent;\n"
+                        "            node->hashValue = 0;\n"
+                        "        }\n";
+            } else {
+                // No parents to follow
+                *str += "    // Clears this node only, see clearHashPath\n"
+                        "    void clearHash() {\n"
+                        "        hashValue = 0;\n";
+            }
+            *str += "    }\n";
+        }
+        *str += "    virtual ~AstNode() {}\n"
+                "};\n";
+    }
+
+    // Hash and equality over members and list contents.
+    // computeHash and equalMembers per constructed class,
+    // with AstNode::hash and equals switching on nodeType.
+    void generateStructuralHash(string *str) {
+        bool memo = langData->options.hasMemoHash();
+        *str += "inline uint64_t hashCombine(uint64_t hash, uint64_t val) {\n"
+                "    hash ^= val + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);\n"
+                "    return hash;\n"
+                "}\n"
+                "inline uint64_t hashString(const std::string &val) {\n"
+                "    uint64_t hash = 0xcbf29ce484222325ULL;\n"
+                "    for (char c : val) {\n"
+                "        hash ^= (unsigned char)c;\n"
+                "        hash *= 0x100000001b3ULL;\n"
+                "    }\n"
+                "    return hash;\n"
+                "}\n"
+                "inline uint64_t hashDouble(double val) {\n"
+                "    // Equal values, equal hash\n"
+                "    if (val == 0) val = 0;\n"
+                "    uint64_t bits;\n"
+                "    memcpy(&bits, &val, 8);\n"
+                "    return bits;\n"
+                "}\n";
+        vector<AstClass*> classes;
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() > 0) classes.push_back(astClass.second);
+        }
+        for (AstClass *cls : classes) {
+            *str += "inline uint64_t computeHash(" + cls->identifier + " *node) {\n";
+            *str += "    uint64_t hash = " + cls->identifier + "Node;\n";
+            for (auto const &member : cls->members) {
+                string value = "node->" + member.first;
+                switch (member.second->typedPart->type) {
+                    case PSTRING:
+                    case PTOKEN:
+                    *str += "    hash = hashCombine(hash, hashString(" + value + "));\n";
+                    break;
+                    case PINT:
+                    case PENUM:
+                    *str += "    hash = hashCombine(hash, (uint64_t)" + value + ");\n";
+                    break;
+                    case PFLOAT:
+                    *str += "    hash = hashCombine(hash, hashDouble(" + value + "));\n";
+                    break;
+                    case PAST:
+                    *str += "    hash = hashCombine(hash, (" + value + " == nullptr) ? 0 : " + value + "->hash());\n";
+                    break;
+                    case PLIST: {
+                    string list = listPtr("node", member.first);
+                    string indent = openListPresent(str, "node", member.first);
+                    *str += indent + "hash = hashCombine(hash, " + list + "->size());\n";
+                    *str += indent + "for (AstNode *child : *" + list + ") {\n";
+                    *str += indent + "    hash = hashCombine(hash, (child == nullptr) ? 0 : child->hash());\n";
+                    *str += indent + "}\n";
+                    closeListPresent(str);
+                    }
+                    break;
+                }
+            }
+            *str += "    return hash;\n"
+                    "}\n";
+            *str += "inline bool equalMembers(" + cls->identifier + " *a, " + cls->identifier + " *b) {\n";
+            for (auto const &member : cls->members) {
+                string left = "a->" + member.first;
+                string right = "b->" + member.first;
+                switch (member.second->typedPart->type) {
+                    case PAST:
+                    *str += "    if (" + left + " != " + right + ") {\n";
+                    *str += "        if (" + left + " == nullptr || !" + left + "->equals(" + right + ")) return false;\n";
+                    *str += "    }\n";
+                    break;
+                    case PLIST:
+                    left = listPtr("a", member.first);
+                    right = listPtr("b", member.first);
+                    *str += "    if (" + left + " != " + right + ") {\n";
+                    if (langData->options.inlineListSlots == 0) {
+                        *str += "        if (" + left + " == nullptr || " + right + " == nullptr) return false;\n";
+                    }
+                    *str += "        if (" + left + "->size() != " + right + "->size()) return false;\n";
+                    *str += "        for (size_t i = 0; i < " + left + "->size(); ++i) {\n";
+                    *str += "            AstNode *child = (*" + left + ")[i];\n";
+                    *str += "            AstNode *otherChild = (*" + right + ")[i];\n";
+                    *str += "            if (child == otherChild) continue;\n";
+                    *str += "            if (child == nullptr || !child->equals(otherChild)) return false;\n";
+                    *str += "        }\n";
+                    *str += "    }\n";
+                    break;
+                    default:
+                    *str += "    if (" + left + " != " + right + ") return false;\n";
+                    break;
+                }
+            }
+            *str += "    return true;\n"
+                    "}\n";
+        }
+        *str += "inline uint64_t AstNode::hash() {\n";
+        if (memo) *str += "    if (hashValue != 0) return hashValue;\n";
+        *str += "    uint64_t hash;\n"
+                "    switch (nodeType) {\n";
+        for (AstClass *cls : classes) {
+            *str += "        case " + cls->identifier + "Node: ";
+            *str += "hash = computeHash(static_cast<" + cls->identifier + "*>(this));break;\n";
+        }
+        *str += "        default: hash = nodeType;break;\n"
+                "    }\n";
+        if (memo) {
+            *str += "    // Zero is reserved for not computed\n"
+                    "    if (hash == 0) hash = 1;\n"
+                    "    hashValue = hash;\n";
+        }
+        *str += "    return hash;\n"
+                "}\n";
+        *str += "inline bool AstNode::equals(AstNode *other) {\n"
+                "    if (other == this) return true;\n"
+                "    if (other == nullptr || other->nodeType != nodeType) return false;\n";
+        if (memo) *str += "    if (hash() != other->hash()) return false;\n";
+        *str += "    switch (nodeType) {\n";
+        for (AstClass *cls : classes) {
+            *str += "        case " + cls->identifier + "Node: ";
+            *str += "return equalMembers(static_cast<" + cls->identifier + "*>(this), static_cast<" + cls->identifier + "*>(other));\n";
+        }
+        *str += "        default: return true;\n"
+                "    }\n"
+                "}\n";
+        // For unordered containers keyed on trees
+        *str += "struct AstNodeHash {\n"
+                "    size_t operator()(AstNode *node) const { return (size_t)node->hash(); }\n"
+                "};\n"
+                "struct AstNodeEqual {\n"
+                "    bool operator()(AstNode *a, AstNode *b) const { return a->equals(b); }\n"
+                "};\n";
+        if (memo && !langData->options.hasParent()) {
+            *str += "// Call after changing target other than by setters,\n"
+                    "// clearing hashes from root down to it. A shared\n"
+                    "// node needs this for each root holding it.\n"
+                    "inline bool clearHashPath(AstNode *root, AstNode *target) {\n"
+                    "    std::vector<AstNode*> path;\n"
+                    "    if (!findPath(root, target, path)) return false;\n"
+                    "    for (AstNode *node : path) node->hashValue = 0;\n"
+                    "    return true;\n"
+                    "}\n";
+        }
+        if (langData->options.hashCons) {
+            generateHashCons(str, classes);
+        }
+    }
+
+    // Table of canonical nodes for the current parse.
+    // Duplicates are deleted along with their own lists,
+    // children are shared so they are kept.
+    void generateHashCons(string *str, vector<AstClass*> &classes) {
+        *str += "typedef std::unordered_set<AstNode*, AstNodeHash, AstNodeEqual> HashConsTable;\n"
+                "extern HashConsTable *hashCons;\n";
+        for (AstClass *cls : classes) {
+            *str += "inline void discardDuplicate(" + cls->identifier + " *node) {\n";
+            for (auto const &member : cls->members) {
+                if (member.second->typedPart->type == PLIST && langData->options.inlineListSlots == 0) {
+                    *str += "    delete node->" + member.first + ";\n";
+                }
+            }
+            *str += "    delete node;\n"
+                    "}\n";
+        }
+    }
+
+    // forEachChild(node, f) calls f with each ast child
+    // of node. Overloads for each constructed class, and
+    // one for AstNode switching on nodeType.
+    void generateChildIteration(string *str) {
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "template<typename F>\n";
+            *str += "inline void forEachChild(" + cls->identifier + " *node, F f) {\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    *str += "    if (node->" + member.first + " != nullptr) f(node->" + member.first + ");\n";
+                } else if (typedPart->type == PLIST) {
+                    TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+                    if (listType->type->type != PAST) continue;
+                    string indent = openListPresent(str, "node", member.first);
+                    // Spilled items are null
+                    string skip = langData->isSpillList(typedPart->identifier) ? "if (child != nullptr) " : "";
+                    *str += indent + "for (AstNode *child : *" + listPtr("node", member.first) + ") " + skip + "f(child);\n";
+                    closeListPresent(str);
+                }
+            }
+            *str += "}\n";
+        }
+        *str += "template<typename F>\n"
+                "inline void forEachChild(AstNode *node, F f) {\n"
+                "    switch (node->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "        case " + cls->identifier + "Node: ";
+            *str += "forEachChild(static_cast<" + cls->identifier + "*>(node), f);break;\n";
+        }
+        *str += "        default:break;\n"
+                "    }\n"
+                "}\n"
+                "// Nodes from root down to target, inclusive\n"
+                "inline bool findPath(AstNode *root, AstNode *target, std::vector<AstNode*> &path) {\n"
+                "    std::vector<std::pair<AstNode*, size_t>> work;\n"
+                "    path.clear();\n"
+                "    if (root != nullptr) work.push_back(std::make_pair(root, (size_t)0));\n"
+                "    while (!work.empty()) {\n"
+                "        std::pair<AstNode*, size_t> item = work.back();\n"
+                "        work.pop_back();\n"
+                "        path.resize(item.second);\n"
+                "        path.push_back(item.first);\n"
+                "        if (item.first == target) return true;\n"
+                "        forEachChild(item.first, [&work, &item](AstNode *child) {\n"
+                "            work.push_back(std::make_pair(child, item.second + 1));\n"
+                "        });\n"
+                "    }\n"
+                "    path.clear();\n"
+                "    return false;\n"
+                "}\n";
+    }
+
+    // Spilled items are deleted while the parse goes
+    // on, so nothing else may hold on to them
+    void checkSpillOptions() {
+        if (langData->options.nodeIndex || langData->options.hashCons ||
+            langData->options.lazyNodes || langData->options.inlineListSlots > 0) {
+            printf("Spill can't be combined with node index, hash consing, lazy nodes or inline lists\n");
+            exit(1);
+        }
+        // Ranges would need to know how many
+        // items before them were spilled
+        if (langData->options.toSourceParallel) {
+            printf("Spill can't be combined with parallel ToSource\n");
+            exit(1);
+        }
+        // Items of nested lists would be lost when
+        // the item holding them is written
+        TypedPart *startPart = langData->startAction->startPart;
+        string startClass = (startPart->type == PAST) ? static_cast<TypedPartAst*>(startPart)->astClass : "";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.first == startClass) continue;
+            for (auto const &member : astClass.second->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PLIST && langData->isSpillList(typedPart->identifier)) {
+                    printf("Spilled list %s is also held by %s\n", typedPart->identifier.c_str(), astClass.first.c_str());
+                    exit(1);
+                }
+            }
+        }
+    }
+    // Hook for the grammar, implemented by the
+    // spill store in the snapshot header
+    void generateSpillSink(string *str) {
+        *str += "class SpillSink {\n"
+                "public:\n"
+                "    virtual ~SpillSink() {}\n"
+                "    // Takes the item at index of list\n"
+                "    virtual void spill(AstNode *node, const void *list, size_t index) = 0;\n"
+                "};\n"
+                "extern SpillSink *spillSink;\n"
+                "template<typename T, typename L>\n"
+                "inline T* spillItem(T *node, L *list) {\n"
+                "    if (spillSink == nullptr || node == nullptr) return node;\n"
+                "    spillSink->spill(node, list, list->size());\n"
+                "    return nullptr;\n"
+                "}\n";
+    }
+
+    // Deletes nodes and their list members with an
+    // explicit worklist, so deep trees can't overflow
+    // the stack. Shared nodes of hash consing are
+    // deleted once.
+    void generateDestroyTree(string *str) {
+        bool shared = langData->options.hashCons;
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "inline void destroyMembers(" + cls->identifier + " *node, std::vector<AstNode*> &work) {\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    *str += "    if (node->" + member.first + " != nullptr) work.push_back(node->" + member.first + ");\n";
+                } else if (typedPart->type == PLIST) {
+                    TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+                    string indent = openListPresent(str, "node", member.first);
+                    if (listType->type->type == PAST) {
+                        *str += indent + "for (AstNode *child : *" + listPtr("node", member.first) + ") {\n" +
+                                indent + "    if (child != nullptr) work.push_back(child);\n" +
+                                indent + "}\n";
+                    }
+                    if (langData->options.inlineListSlots == 0) {
+                        // Inline lists are freed with the node
+                        *str += indent + "delete node->" + member.first + ";\n" +
+                                indent + "node->" + member.first + " = nullptr;\n";
+                    }
+                    closeListPresent(str);
+                }
+            }
+            *str += "}\n";
+        }
+        *str += "inline void destroyNodes(std::vector<AstNode*> &work) {\n";
+        if (shared) {
+            *str += "    std::unordered_set<AstNode*> deleted;\n";
+        }
+        *str += "    while (!work.empty()) {\n"
+                "        AstNode *node = work.back();\n"
+                "        work.pop_back();\n";
+        if (shared) {
+            *str += "        if (!deleted.insert(node).second) continue;\n";
+        }
+        *str += "        switch (node->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "            case " + cls->identifier + "Node: ";
+            *str += "destroyMembers(static_cast<" + cls->identifier + "*>(node), work);break;\n";
+        }
+        *str += "            default:break;\n"
+                "        }\n"
+                "        delete node;\n"
+                "    }\n"
+                "}\n"
+                "inline void destroyTree(AstNode *root) {\n"
+                "    if (root == nullptr) return;\n"
+                "    std::vector<AstNode*> work;\n"
+                "    work.reserve(64);\n"
+                "    work.push_back(root);\n"
+                "    destroyNodes(work);\n"
+                "}\n";
+        if (langData->startAction->startPart->type == PLIST) {
+            // Root list from the parser
+            *str += "template<typename T>\n"
+                    "inline void destroyTree(std::vector<T*> *list) {\n"
+                    "    if (list == nullptr) return;\n"
+                    "    std::vector<AstNode*> work;\n"
+                    "    for (T *node : *list) {\n"
+                    "        if (node != nullptr) work.push_back(node);\n"
+                    "    }\n"
+                    "    delete list;\n"
+                    "    destroyNodes(work);\n"
+                    "}\n";
+        }
+    }
+
+    // Allocators, and node copies with the same children.
+    // Allocators have make<T>(), default constructing a T.
+    void generateShallowClone(string *str) {
+        bool inlineLists = langData->options.inlineListSlots > 0;
+        *str += "#include <new>\n"
+                "#include <stdlib.h>\n";
+        *str += "// Nodes released with delete or destroyTree\n"
+                "struct HeapAllocator {\n"
+                "    template<typename T>\n"
+                "    T* make() { return new T(); }\n"
+                "};\n"
+                "// Bump allocator owning everything made in it,\n"
+                "// destroyed in reverse order with the arena\n"
+                "class NodeArena {\n"
+                "public:\n"
+                "    explicit NodeArena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}\n"
+                "    NodeArena(const NodeArena&) = delete;\n"
+                "    NodeArena& operator=(const NodeArena&) = delete;\n"
+                "    ~NodeArena() {\n"
+                "        for (size_t i = destructors.size(); i > 0; --i) {\n"
+                "            destructors[i - 1].destroy(destructors[i - 1].object);\n"
+                "        }\n"
+                "        for (char *block : blocks) free(block);\n"
+                "    }\n"
+                "    template<typename T>\n"
+                "    T* make() {\n"
+                "        T *object = new (allocate(sizeof(T), alignof(T))) T();\n"
+                "        destructors.push_back(Destructor{object, [](void *p) { static_cast<T*>(p)->~T(); }});\n"
+                "        return object;\n"
+                "    }\n"
+                "    void* allocate(size_t size, size_t align) {\n"
+                "        uintptr_t p = ((uintptr_t)pos + align - 1) & ~(uintptr_t)(align - 1);\n"
+                "        if (pos == nullptr || p + size > (uintptr_t)end) {\n"
+                "            size_t len = (size + align > blockSize) ? size + align : blockSize;\n"
+                "            char *block = (char*)malloc(len);\n"
+                "            if (block == nullptr) {\n"
+                "                printf(\"Out of memory in arena\\n\");\n"
+                "                exit(1);\n"
+                "            }\n"
+                "            blocks.push_back(block);\n"
+                "            pos = block;\n"
+                "            end = block + len;\n"
+                "            p = ((uintptr_t)pos + align - 1) & ~(uintptr_t)(align - 1);\n"
+                "        }\n"
+                "        pos = (char*)(p + size);\n"
+                "        return (void*)p;\n"
+                "    }\n"
+                "private:\n"
+                "    struct Destructor {\n"
+                "        void *object;\n"
+                "        void (*destroy)(void*);\n"
+                "    };\n"
+                "    size_t blockSize;\n"
+                "    std::vector<char*> blocks;\n"
+                "    std::vector<Destructor> destructors;\n"
+                "    char *pos = nullptr;\n"
+                "    char *end = nullptr;\n"
+                "};\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "template<typename A>\n"
+                    "inline " + cls->identifier + "* shallowClone(" + cls->identifier + " *node, A &alloc) {\n"
+                    "    " + cls->identifier + " *copy = alloc.template make<" + cls->identifier + ">();\n"
+                    "    // Base fields, as locations and masks\n"
+                    "    static_cast<AstNode&>(*copy) = static_cast<const AstNode&>(*node);\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type != PLIST) {
+                    *str += "    copy->" + member.first + " = node->" + member.first + ";\n";
+                    continue;
+                }
+                string elemType;
+                static_cast<TypedPartList*>(typedPart)->type->generateGrammarType(&elemType, langData);
+                if (inlineLists) {
+                    *str += "    copy->" + member.first + ".reserve(node->" + member.first + ".size());\n"
+                            "    for (" + elemType + " child : node->" + member.first + ") copy->" + member.first + ".push_back(child);\n";
+                } else {
+                    *str += "    if (node->" + member.first + " != nullptr) {\n"
+                            "        copy->" + member.first + " = alloc.template make<std::vector<" + elemType + ">>();\n"
+                            "        copy->" + member.first + "->reserve(node->" + member.first + "->size());\n"
+                            "        copy->" + member.first + "->insert(copy->" + member.first + "->end(), node->" + member.first + "->begin(), node->" + member.first + "->end());\n"
+                            "    } else {\n"
+                            "        copy->" + member.first + " = nullptr;\n"
+                            "    }\n";
+                }
+            }
+            *str += "    return copy;\n"
+                    "}\n";
+        }
+        *str += "template<typename A>\n"
+                "inline AstNode* shallowClone(AstNode *node, A &alloc) {\n"
+                "    switch (node->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "        case " + cls->identifier + "Node: return shallowClone(static_cast<" + cls->identifier + "*>(node), alloc);\n";
+        }
+        *str += "        default: return nullptr;\n"
+                "    }\n"
+                "}\n";
+    }
+
+    // Shallow copies keep the hash and mask of the
+    // node they were copied from
+    void resetCopyCaches(string *str) {
+        if (langData->options.hasMemoHash()) {
+            *str += "    copy->hashValue = 0;\n";
+        }
+        if (langData->options.subtreeMask) {
+            *str += "    copy->subtreeMask = computeSubtreeMask(copy);\n";
+        }
+    }
+
+    // Path copying updates. withX() gives a copy of a
+    // node with one member replaced, and withPath() the
+    // new root above it. Other subtrees are shared, and
+    // list vectors are owned by one node.
+    void generatePersistentNodes(string *str) {
+        bool inlineLists = langData->options.inlineListSlots > 0;
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            string className = cls->identifier;
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                string withName = member.first;
+                withName[0] = std::toupper(withName[0]);
+                withName = "with" + withName;
+                string param;
+                string assign;
+                if (typedPart->type == PLIST) {
+                    string elemType;
+                    static_cast<TypedPartList*>(typedPart)->type->generateGrammarType(&elemType, langData);
+                    param = "const std::vector<" + elemType + "> &" + member.first;
+                    if (inlineLists) {
+                        assign = "    copy->" + member.first + ".clear();\n"
+                                 "    copy->" + member.first + ".reserve(" + member.first + ".size());\n"
+                                 "    for (" + elemType + " elem : " + member.first + ") copy->" + member.first + ".push_back(elem);\n";
+                    } else {
+                        assign = "    if (copy->" + member.first + " == nullptr) copy->" + member.first + " = alloc.template make<std::vector<" + elemType + ">>();\n"
+                                 "    copy->" + member.first + "->assign(" + member.first + ".begin(), " + member.first + ".end());\n";
+                    }
+                } else {
+                    string type;
+                    typedPart->generateGrammarType(&type, langData);
+                    param = type + " " + member.first;
+                    if (typedPart->type == PSTRING) {
+                        assign = "    copy->" + member.first + " = std::move(" + member.first + ");\n";
+                    } else {
+                        assign = "    copy->" + member.first + " = " + member.first + ";\n";
+                    }
+                }
+                *str += "template<typename A>\n"
+                        "inline " + className + "* " + withName + "(" + className + " *node, " + param + ", A &alloc) {\n"
+                        "    " + className + " *copy = shallowClone(node, alloc);\n" + assign;
+                resetCopyCaches(str);
+                *str += "    return copy;\n"
+                        "}\n";
+                string arg = (typedPart->type == PSTRING) ? "std::move(" + member.first + ")" : member.first;
+                *str += "inline " + className + "* " + withName + "(" + className + " *node, " + param + ") {\n"
+                        "    HeapAllocator alloc;\n"
+                        "    return " + withName + "(node, " + arg + ", alloc);\n"
+                        "}\n";
+            }
+            // Copy with one child pointer swapped
+            *str += "template<typename A>\n"
+                    "inline " + className + "* withChild(" + className + " *node, AstNode *oldChild, AstNode *newChild, A &alloc) {\n"
+                    "    " + className + " *copy = shallowClone(node, alloc);\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    string type;
+                    typedPart->generateGrammarType(&type, langData);
+                    *str += "    if (copy->" + member.first + " == oldChild) copy->" + member.first + " = static_cast<" + type + ">(newChild);\n";
+                } else if (typedPart->type == PLIST) {
+                    TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+                    if (listType->type->type != PAST) continue;
+                    string elemType;
+                    listType->type->generateGrammarType(&elemType, langData);
+                    string indent = openListPresent(str, "copy", member.first);
+                    *str += indent + "for (" + elemType + " &elem : *" + listPtr("copy", member.first) + ") {\n" +
+                            indent + "    if (elem == oldChild) elem = static_cast<" + elemType + ">(newChild);\n" +
+                            indent + "}\n";
+                    closeListPresent(str);
+                }
+            }
+            resetCopyCaches(str);
+            *str += "    return copy;\n"
+                    "}\n";
+        }
+        *str += "template<typename A>\n"
+                "inline AstNode* withChild(AstNode *node, AstNode *oldChild, AstNode *newChild, A &alloc) {\n"
+                "    switch (node->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "        case " + cls->identifier + "Node: return withChild(static_cast<" + cls->identifier + "*>(node), oldChild, newChild, alloc);\n";
+        }
+        *str += "        default: return nullptr;\n"
+                "    }\n"
+                "}\n"
+                "// New root with the last node of path replaced,\n"
+                "// copying only the nodes above it\n"
+                "template<typename A>\n"
+                "inline AstNode* withPath(const std::vector<AstNode*> &path, AstNode *replacement, A &alloc) {\n"
+                "    AstNode *current = replacement;\n"
+                "    for (size_t i = path.size(); i > 1; --i) {\n"
+                "        current = withChild(path[i - 2], path[i - 1], current, alloc);\n"
+                "    }\n"
+                "    return current;\n"
+                "}\n"
+                "inline AstNode* withPath(const std::vector<AstNode*> &path, AstNode *replacement) {\n"
+                "    HeapAllocator alloc;\n"
+                "    return withPath(path, replacement, alloc);\n"
+                "}\n";
+    }
+
+    // Copies a subtree in one pass over a worklist of
+    // copies whose children still point into the source
+    void generateCloneTree(string *str) {
+        bool shared = langData->options.hashCons;
+        if (shared) {
+            *str += "#include <unordered_map>\n";
+        }
+        string mapArg = shared ? ", std::unordered_map<AstNode*, AstNode*> &copies" : "";
+        // Replaces children of a copy with copies of them
+        string childCopy = shared ? "cloneChild(child, alloc, work, copies)" : "cloneChild(child, alloc, work)";
+        *str += "template<typename A>\n"
+                "inline AstNode* cloneChild(AstNode *child, A &alloc, std::vector<AstNode*> &work" + mapArg + ") {\n";
+        if (shared) {
+            // Shared nodes stay shared in the copy
+            *str += "    auto found = copies.find(child);\n"
+                    "    if (found != copies.end()) return found->second;\n"
+                    "    AstNode *copy = shallowClone(child, alloc);\n"
+                    "    copies[child] = copy;\n";
+        } else {
+            *str += "    AstNode *copy = shallowClone(child, alloc);\n";
+        }
+        *str += "    work.push_back(copy);\n"
+                "    return copy;\n"
+                "}\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "template<typename A>\n"
+                    "inline void cloneChildren(" + cls->identifier + " *copy, A &alloc, std::vector<AstNode*> &work" + mapArg + ") {\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    string type;
+                    typedPart->generateGrammarType(&type, langData);
+                    *str += "    if (copy->" + member.first + " != nullptr) {\n"
+                            "        AstNode *child = copy->" + member.first + ";\n"
+                            "        copy->" + member.first + " = static_cast<" + type + ">(" + childCopy + ");\n";
+                    if (langData->options.hasParent()) {
+                        *str += "        copy->" + member.first + "->parent = copy;\n";
+                    }
+                    *str += "    }\n";
+                } else if (typedPart->type == PLIST) {
+                    TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+                    if (listType->type->type != PAST) continue;
+                    string elemType;
+                    listType->type->generateGrammarType(&elemType, langData);
+                    string indent = openListPresent(str, "copy", member.first);
+                    *str += indent + "for (" + elemType + " &elem : *" + listPtr("copy", member.first) + ") {\n" +
+                            indent + "    if (elem == nullptr) continue;\n" +
+                            indent + "    AstNode *child = elem;\n" +
+                            indent + "    elem = static_cast<" + elemType + ">(" + childCopy + ");\n";
+                    if (langData->options.hasParent()) {
+                        *str += indent + "    elem->parent = copy;\n";
+                    }
+                    *str += indent + "}\n";
+                    closeListPresent(str);
+                }
+            }
+            *str += "}\n";
+        }
+        string mapParam = shared ? ", copies" : "";
+        *str += "template<typename T, typename A>\n"
+                "inline T* clone(T *node, A &alloc) {\n"
+                "    if (node == nullptr) return nullptr;\n"
+                "    std::vector<AstNode*> work;\n";
+        if (shared) {
+            *str += "    std::unordered_map<AstNode*, AstNode*> copies;\n";
+        }
+        *str += "    T *root = static_cast<T*>(" + string(shared ? "cloneChild(node, alloc, work, copies)" : "cloneChild(node, alloc, work)") + ");\n";
+        if (langData->options.hasParent()) {
+            *str += "    root->parent = nullptr;\n";
+        }
+        *str += "    while (!work.empty()) {\n"
+                "        AstNode *copy = work.back();\n"
+                "        work.pop_back();\n"
+                "        switch (copy->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "            case " + cls->identifier + "Node: cloneChildren(static_cast<" + cls->identifier + "*>(copy), alloc, work" + mapParam + ");break;\n";
+        }
+        *str += "            default:break;\n"
+                "        }\n"
+                "    }\n"
+                "    return root;\n"
+                "}\n";
+    }
+
+    // Smallest unsigned type with a bit
+    // for each NodeType
+    void generateNodeMaskType(string *str) {
+        size_t numTypes = langData->astClasses.size();
+        if (numTypes > 64) {
+            printf("Subtree mask supports up to 64 node types\n");
+            exit(1);
+        }
+        *str += (numTypes > 32) ? "typedef uint64_t NodeMask;\n" : "typedef uint32_t NodeMask;\n";
+        *str += "inline NodeMask nodeMask(NodeType nodeType) {\n"
+                "    return NodeMask(1) << nodeType;\n"
+                "}\n";
+    }
+
+    // Mask of a node is its own NodeType bit or'ed
+    // with the masks of its children. Children are
+    // finished before parents, so one level is enough.
+    void generateSubtreeMasks(string *str) {
+        for (auto const &astClass : langData->astClasses) {
+            AstClass *cls = astClass.second;
+            if (cls->constructors.size() == 0) continue;
+            *str += "inline NodeMask computeSubtreeMask(" + cls->identifier + " *node) {\n";
+            *str += "    NodeMask mask = nodeMask(" + cls->identifier + "Node);\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    *str += "    if (node->" + member.first + " != nullptr) ";
+                    *str += "mask |= node->" + member.first + "->subtreeMask;\n";
+                } else if (typedPart->type == PLIST) {
+                    TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+                    if (listType->type->type != PAST) continue;
+                    string indent = openListPresent(str, "node", member.first);
+                    string skip = langData->isSpillList(typedPart->identifier) ? "if (child != nullptr) " : "";
+                    *str += indent + "for (AstNode *child : *" + listPtr("node", member.first) + ") " + skip + "mask |= child->subtreeMask;\n";
+                    closeListPresent(str);
+                }
+            }
+            *str += "    return mask;\n"
+                    "}\n";
+        }
+        if (langData->options.hasParent()) {
+            // Ancestors of a changed node, until one is unchanged
+            *str += "inline void updateSubtreeMasks(AstNode *node) {\n"
+                    "    while (node != nullptr) {\n"
+                    "        NodeMask mask;\n"
+                    "        switch (node->nodeType) {\n";
+            for (auto const &astClass : langData->astClasses) {
+                AstClass *cls = astClass.second;
+                if (cls->constructors.size() == 0) continue;
+                *str += "            case " + cls->identifier + "Node: mask = computeSubtreeMask(static_cast<" + cls->identifier + "*>(node)); break;\n";
+            }
+            *str += "            default: mask = ~NodeMask(0); break;\n"
+                    "        }\n"
+                    "        if (mask == node->subtreeMask) return;\n"
+                    "        node->subtreeMask = mask;\n"
+                    "        node = node->parent;\n"
+                    "    }\n"
+                    "}\n";
+        }
+        // Query helper
+        *str += "inline bool subtreeHas(AstNode *node, NodeMask mask) {\n"
+                "    return (node->subtreeMask & mask) != 0;\n"
+                "}\n";
+    }
+
+    // Index with a vector of nodes for each
+    // NodeType, so all nodes of a class can
+    // be found without a traversal.
+    void generateNodeIndex(string *str) {
+        *str += "class NodeIndex {\n"
+                "public:\n"
+                "    std::vector<AstNode*> nodes[NodeTypeCount];\n"
+                "    void add(AstNode *node) {\n"
+                "        nodes[node->nodeType].push_back(node);\n"
+                "    }\n"
+                "    const std::vector<AstNode*>& get(NodeType nodeType) const {\n"
+                "        return nodes[nodeType];\n"
+                "    }\n"
+                "    void clear() {\n"
+                "        for (int i = 0; i < NodeTypeCount; ++i) nodes[i].clear();\n"
+                "    }\n"
+                "};\n";
+        *str += "extern NodeIndex *nodeIndex;\n";
+    }
+
+    // Hook run by construction actions on every
+    // new node, body depends on enabled options
+    void generateFinishNode(string *str) {
+        *str += "template<typename T>\n"
+                "inline T* finishNode(T *node) {\n";
+        if (langData->options.subtreeMask) {
+            *str += "    node->subtreeMask = computeSubtreeMask(node);\n";
+        }
+        if (langData->options.hashCons) {
+            *str += "    if (hashCons != nullptr) {\n"
+                    "        auto inserted = hashCons->insert(node);\n"
+                    "        if (!inserted.second) {\n"
+                    "            discardDuplicate(node);\n"
+                    "            return static_cast<T*>(*inserted.first);\n"
+                    "        }\n"
+                    "    }\n";
+        }
+        if (langData->options.nodeIndex) {
+            *str += "    if (nodeIndex != nullptr) nodeIndex->add(node);\n";
+        }
+        if (langData->options.hasParent()) {
+            *str += "    forEachChild(node, [node](AstNode *child) { child->parent = node; });\n";
+        }
+        if (langData->options.hasMemoHash() && !langData->options.hashCons) {
+            // Children are memoized already
+            *str += "    node->hash();\n";
+        }
+        *str += "    return node;\n"
+                "}\n";
+    }
+    // Parse events in postorder, one per reduce. Node
+    // events hold an arg per member: child event, value
+    // or string index. Lists are chains of item events.
+    void generateLazyTree(string *str) {
+        vector<AstClass*> classes;
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() > 0) classes.push_back(astClass.second);
+        }
+        *str += "#include <initializer_list>\n"
+                "#include <stdlib.h>\n"
+                "enum LazyEventKind : uint32_t {\n"
+                "    NullEvent = 0xfffffffd,\n"
+                "    EmptyListEvent,\n"
+                "    ListItemEvent\n"
+                "};\n"
+                "struct ParseEvent {\n"
+                "    // NodeType for nodes\n"
+                "    uint32_t kind;\n"
+                "    // Args of nodes, or items up to this one in lists\n"
+                "    uint32_t count;\n"
+                "    // First arg of nodes, or the previous list event\n"
+                "    uint32_t link;\n"
+                "    // Element of list items\n"
+                "    uint32_t elem;\n"
+                "    uint32_t start;\n"
+                "    uint32_t end;\n"
+                "};\n"
+                "class LazyTree {\n"
+                "public:\n"
+                "    // Event zero is null\n"
+                "    std::vector<ParseEvent> events;\n"
+                "    std::vector<uint64_t> args;\n"
+                "    std::vector<std::string> strings;\n"
+                "    // Materialized node of each event, owned by the caller\n"
+                "    std::vector<AstNode*> nodes;\n"
+                "    uint32_t root = 0;\n"
+                "    LazyTree() {\n"
+                "        events.push_back(ParseEvent{NullEvent, 0, 0, 0, 0, 0});\n"
+                "        strings.push_back(std::string());\n"
+                "    }\n"
+                "    template<typename L>\n"
+                "    uint32_t addNode(NodeType kind, const L &first, const L &last, std::initializer_list<uint64_t> nodeArgs) {\n"
+                "        uint32_t link = (uint32_t)args.size();\n"
+                "        args.insert(args.end(), nodeArgs.begin(), nodeArgs.end());\n"
+                "        events.push_back(ParseEvent{(uint32_t)kind, (uint32_t)nodeArgs.size(), link, 0, first.start, last.end});\n"
+                "        return (uint32_t)events.size() - 1;\n"
+                "    }\n"
+                "    template<typename L>\n"
+                "    uint32_t addEmptyList(const L &loc) {\n"
+                "        events.push_back(ParseEvent{EmptyListEvent, 0, 0, 0, loc.start, loc.end});\n"
+                "        return (uint32_t)events.size() - 1;\n"
+                "    }\n"
+                "    template<typename L>\n"
+                "    uint32_t addListItem(uint32_t list, uint32_t elem, const L &loc) {\n"
+                "        events.push_back(ParseEvent{ListItemEvent, events[list].count + 1, list, elem, loc.start, loc.end});\n"
+                "        return (uint32_t)events.size() - 1;\n"
+                "    }\n"
+                "    uint64_t stringArg(char *val) {\n"
+                "        strings.push_back(val);\n"
+                "        free(val);\n"
+                "        return strings.size() - 1;\n"
+                "    }\n"
+                "    uint64_t stringArg(std::string *val) {\n"
+                "        strings.push_back(std::move(*val));\n"
+                "        delete val;\n"
+                "        return strings.size() - 1;\n"
+                "    }\n"
+                "    template<typename T>\n"
+                "    static uint64_t valueArg(T val) {\n"
+                "        return (uint64_t)(int64_t)val;\n"
+                "    }\n"
+                "    static uint64_t floatArg(double val) {\n"
+                "        uint64_t bits;\n"
+                "        memcpy(&bits, &val, sizeof(bits));\n"
+                "        return bits;\n"
+                "    }\n"
+                "    static double floatValue(uint64_t bits) {\n"
+                "        double val;\n"
+                "        memcpy(&val, &bits, sizeof(val));\n"
+                "        return val;\n"
+                "    }\n"
+                "    bool isNode(uint32_t event) const {\n"
+                "        return events[event].kind < NullEvent;\n"
+                "    }\n"
+                "    NodeType kind(uint32_t event) const {\n"
+                "        return (NodeType)events[event].kind;\n"
+                "    }\n"
+                "    uint64_t arg(uint32_t event, size_t i) const {\n"
+                "        return args[events[event].link + i];\n"
+                "    }\n"
+                "    // Element events of a list, in order\n"
+                "    std::vector<uint32_t> listItems(uint32_t list) const {\n"
+                "        std::vector<uint32_t> items(events[list].count);\n"
+                "        for (uint32_t event = list; events[event].kind == ListItemEvent; event = events[event].link) {\n"
+                "            items[events[event].count - 1] = events[event].elem;\n"
+                "        }\n"
+                "        return items;\n"
+                "    }\n"
+                "    template<typename T>\n"
+                "    std::vector<T>* materializeList(uint32_t list) {\n"
+                "        if (list == 0) return nullptr;\n"
+                "        std::vector<uint32_t> items = listItems(list);\n"
+                "        std::vector<T> *result = new std::vector<T>;\n"
+                "        result->reserve(items.size());\n"
+                "        for (uint32_t item : items) result->push_back(static_cast<T>(materialize(item)));\n"
+                "        return result;\n"
+                "    }\n"
+                "    // Node of event with its subtree, built once\n"
+                "    AstNode* materialize(uint32_t event) {\n"
+                "        if (event == 0) return nullptr;\n"
+                "        if (nodes.size() < events.size()) nodes.resize(events.size(), nullptr);\n"
+                "        if (nodes[event] != nullptr) return nodes[event];\n"
+                "        AstNode *result;\n"
+                "        switch (events[event].kind) {\n";
+        for (AstClass *cls : classes) {
+            *str += "            case " + cls->identifier + "Node: {\n"
+                    "                " + cls->identifier + " *node = new " + cls->identifier + "();\n";
+            size_t i = 0;
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                string arg = "arg(event, " + std::to_string(i++) + ")";
+                string type;
+                typedPart->generateGrammarType(&type, langData);
+                string target = "                node->" + member.first + " = ";
+                switch (typedPart->type) {
+                    case PSTRING: *str += target + "strings[" + arg + "];\n"; break;
+                    case PFLOAT: *str += target + "floatValue(" + arg + ");\n"; break;
+                    case PINT: *str += target + "(" + type + ")(int64_t)" + arg + ";\n"; break;
+                    case PENUM: *str += target + "(" + type + ")" + arg + ";\n"; break;
+                    case PAST: *str += target + "static_cast<" + type + ">(materialize((uint32_t)" + arg + "));\n"; break;
+                    case PLIST: {
+                        string elemType;
+                        static_cast<TypedPartList*>(typedPart)->type->generateGrammarType(&elemType, langData);
+                        *str += target + "materializeList<" + elemType + ">((uint32_t)" + arg + ");\n";
+                    }
+                    break;
+                    default: break;
+                }
+            }
+            *str += "                result = node;\n"
+                    "            }\n"
+                    "            break;\n";
+        }
+        *str += "            default: return nullptr;\n"
+                "        }\n"
+                "        result->startOffset = events[event].start;\n"
+                "        result->endOffset = events[event].end;\n";
+        if (langData->options.hasParent()) {
+            *str += "        forEachChild(result, [result](AstNode *child) { child->parent = result; });\n";
+        }
+        *str += "        nodes[event] = result;\n"
+                "        return result;\n"
+                "    }\n"
+                "};\n"
+                "extern LazyTree *lazyTree;\n";
+        // Typed views reading members from the events
+        for (AstClass *cls : classes) {
+            string viewName = cls->identifier + "View";
+            *str += "class " + viewName + " {\n"
+                    "public:\n"
+                    "    LazyTree *tree;\n"
+                    "    uint32_t event;\n"
+                    "    " + viewName + "(LazyTree *tree, uint32_t event) : tree(tree), event(event) {}\n";
+            size_t i = 0;
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                string arg = "tree->arg(event, " + std::to_string(i++) + ")";
+                string type;
+                typedPart->generateGrammarType(&type, langData);
+                switch (typedPart->type) {
+                    case PSTRING:
+                    *str += "    const std::string& " + member.first + "() const { return tree->strings[" + arg + "]; }\n";
+                    break;
+                    case PFLOAT:
+                    *str += "    double " + member.first + "() const { return LazyTree::floatValue(" + arg + "); }\n";
+                    break;
+                    case PINT:
+                    *str += "    " + type + " " + member.first + "() const { return (" + type + ")(int64_t)" + arg + "; }\n";
+                    break;
+                    case PENUM:
+                    *str += "    " + type + " " + member.first + "() const { return (" + type + ")" + arg + "; }\n";
+                    break;
+                    case PAST:
+                    *str += "    uint32_t " + member.first + "() const { return (uint32_t)" + arg + "; }\n";
+                    break;
+                    case PLIST:
+                    *str += "    std::vector<uint32_t> " + member.first + "() const { return tree->listItems((uint32_t)" + arg + "); }\n";
+                    break;
+                    default: break;
+                }
+            }
+            *str += "    " + cls->identifier + "* materialize() const {\n"
+                    "        return static_cast<" + cls->identifier + "*>(tree->materialize(event));\n"
+                    "    }\n"
+                    "};\n";
+        }
+    }
+
+    // Source text with a flat array of tokens and
+    // trivia. Nodes are views through their offsets.
+    void generateSyntaxTree(string *str) {
+        *str += "// Starts where the previous token ends\n"
+                "struct SyntaxToken {\n"
+                "    uint32_t start;\n"
+                "    // Grammar token, or zero for trivia\n"
+                "    uint32_t kind;\n"
+                "};\n"
+                "class SyntaxTree {\n"
+                "public:\n"
+                "    std::string text;\n"
+                "    std::vector<SyntaxToken> tokens;\n"
+                "    void add(const char *data, size_t len) {\n"
+                "        tokens.push_back(SyntaxToken{(uint32_t)text.size(), 0});\n"
+                "        text.append(data, len);\n"
+                "    }\n"
+                "    bool isTrivia(size_t i) const {\n"
+                "        return tokens[i].kind == 0;\n"
+                "    }\n"
+                "    uint32_t tokenEnd(size_t i) const {\n"
+                "        return i + 1 < tokens.size() ? tokens[i + 1].start : (uint32_t)text.size();\n"
+                "    }\n"
+                "    // Index of the token containing offset\n"
+                "    size_t tokenAt(uint32_t offset) const {\n"
+                "        size_t low = 0;\n"
+                "        size_t high = tokens.size();\n"
+                "        while (high - low > 1) {\n"
+                "            size_t mid = (low + high) / 2;\n"
+                "            if (tokens[mid].start <= offset) low = mid;\n"
+                "            else high = mid;\n"
+                "        }\n"
+                "        return low;\n"
+                "    }\n"
+                "    std::string source(AstNode *node) const {\n"
+                "        return text.substr(node->startOffset, node->endOffset - node->startOffset);\n"
+                "    }\n"
+                "};\n"
+                "extern SyntaxTree syntaxTree;\n";
+    }
+
+    // Location setter for construction actions, and
+    // line start table to turn offsets into positions
+    void generateLocations(string *str) {
+        *str += "extern uint32_t lexOffset;\n"
+                "template<typename T, typename L>\n"
+                "inline T* setLocation(T *node, const L &first, const L &last) {\n"
+                "    node->startOffset = first.start;\n"
+                "    node->endOffset = last.end;\n"
+                "    return node;\n"
+                "}\n"
+                "struct SourcePosition {\n"
+                "    uint32_t line;\n"
+                "    uint32_t column;\n"
+                "};\n"
+                "class SourceLines {\n"
+                "public:\n"
+                "    // Offset of first byte of each line\n"
+                "    std::vector<uint32_t> lineStarts;\n"
+                "    SourceLines(const char *data, size_t size) {\n"
+                "        lineStarts.push_back(0);\n"
+                "        // memchr is vectorized by the c library\n"
+                "        const char *pos = data;\n"
+                "        const char *end = data + size;\n"
+                "        while (pos < end) {\n"
+                "            const char *newline = (const char*)memchr(pos, '\\n', end - pos);\n"
+                "            if (newline == nullptr) break;\n"
+                "            pos = newline + 1;\n"
+                "            lineStarts.push_back((uint32_t)(pos - data));\n"
+                "        }\n"
+                "    }\n"
+                "    // One based line and column\n"
+                "    SourcePosition position(uint32_t offset) const {\n"
+                "        size_t low = 0;\n"
+                "        size_t high = lineStarts.size();\n"
+                "        while (high - low > 1) {\n"
+                "            size_t mid = (low + high) / 2;\n"
+                "            if (lineStarts[mid] <= offset) low = mid;\n"
+                "            else high = mid;\n"
+                "        }\n"
+                "        return SourcePosition{(uint32_t)low + 1, offset - lineStarts[low] + 1};\n"
+                "    }\n"
+                "    static SourceLines fromFile(std::string fileName) {\n"
+                "        std::string data;\n"
+                "        FILE *file = fopen(fileName.c_str(), \"rb\");\n"
+                "        if (file != nullptr) {\n"
+                "            char buf[4096];\n"
+                "            size_t len;\n"
+                "            while ((len = fread(buf, 1, sizeof(buf), file)) > 0) data.append(buf, len);\n"
+                "            fclose(file);\n"
+                "        }\n"
+                "        return SourceLines(data.data(), data.size());\n"
+                "    }\n"
+                "    // Reads from start, and restores the position\n"
+                "    // and end of file state\n"
+                "    static SourceLines fromStream(FILE *file) {\n"
+                "        std::string data;\n"
+                "        long current = ftell(file);\n"
+                "        bool atEnd = feof(file) != 0;\n"
+                "        if (current >= 0 && fseek(file, 0, SEEK_SET) == 0) {\n"
+                "            char buf[4096];\n"
+                "            size_t len;\n"
+                "            while ((len = fread(buf, 1, sizeof(buf), file)) > 0) data.append(buf, len);\n"
+                "            clearerr(file);\n"
+                "            fseek(file, current, SEEK_SET);\n"
+                "            if (atEnd) fgetc(file);\n"
+                "        }\n"
+                "        return SourceLines(data.data(), data.size());\n"
+                "    }\n"
+                "};\n";
+    }
     void generateVisitor() {
         string *str = new string;
         *str += "#include \"" + langData->langKey + ".hpp\"\n";
@@ -254,6 +2118,14 @@ public:
         // Generate declaration
         *str += "class " + className + " {\n";
         *str += "public:\n";
+        bool useMask = langData->options.subtreeMask;
+        if (useMask) {
+            // Children with none of these types in
+            // their subtree are skipped
+            *str += "   NodeMask wantedMask;\n";
+            *str += "   " + className + "() : wantedMask(~NodeMask(0)) {}\n";
+            *str += "   " + className + "(NodeMask wantedMask) : wantedMask(wantedMask) {}\n";
+        }
         for (auto const &astClass : langData->astClasses) {
             *str += "   virtual void visit" + astClass.second->identifier + "(";
             *str += astClass.second->identifier + " *node);\n";
@@ -282,7 +2154,9 @@ public:
                         case PAST: {
                             TypedPartAst *astPart = static_cast<TypedPartAst*>(member.second->typedPart);
                             AstClass *memberClass = langData->astClasses[astPart->astClass];
-                            *str += "    visit" + memberClass->identifier + "(node->" + member.first + ");\n";
+                            *str += "    ";
+                            if (useMask) *str += "if (node->" + member.first + "->subtreeMask & wantedMask) ";
+                            *str += "visit" + memberClass->identifier + "(node->" + member.first + ");\n";
                         }
                         break;
                         case PLIST: {
@@ -296,8 +2170,15 @@ public:
                                 AstClass *listAstClass = langData->astClasses[listAstPart->astClass];
                                 *str += "    for (";
                                 listType->type->generateGrammarType(str, langData);
-                                *str += " node : *node->" + member.first + ") {\n";
-                                *str += "        visit" + listAstClass->identifier + "(node);\n";
+                                *str += " node : *" + listPtr("node", member.first) + ") {\n";
+                                *str += "        ";
+                                if (langData->isSpillList(listType->identifier)) {
+                                    // Spilled items are null, and read
+                                    // through the spill store instead
+                                    *str += "if (node == nullptr) continue;\n        ";
+                                }
+                                if (useMask) *str += "if (node->subtreeMask & wantedMask) ";
+                                *str += "visit" + listAstClass->identifier + "(node);\n";
                                 *str += "    }\n";
                             }
                         }
@@ -330,134 +2211,148 @@ public:
 
     void generateToSource(SourceNode *source) {
         string *str = new string;
+        bool measure = langData->options.toSourceMeasure;
+        if (measure && langData->options.toSourceSink) {
+            printf("ToSource sink and measure options can't be combined\n");
+            exit(1);
+        }
         *str += "#include \"" + langData->langKey + "Visitor.hpp\"\n";
         *str += "#include <string>\n";
+        if (langData->options.toSourceSink) {
+            generateSourceSinks(str);
+        }
+        if (measure) {
+            *str += "#include <string.h>\n";
+        }
+        bool renderCache = langData->options.renderCache;
+        if (renderCache && langData->options.hasToSourceOut()) {
+            printf("Render cache needs ToSource in string mode\n");
+            exit(1);
+        }
+        bool lossless = langData->options.lossless;
+        if (lossless && langData->options.hasToSourceOut()) {
+            printf("Lossless mode needs ToSource in string mode\n");
+            exit(1);
+        }
+        if (lossless && langData->options.toSourceParallel) {
+            // Trivia is taken in source order
+            printf("Lossless mode can't be combined with ToSource parallel\n");
+            exit(1);
+        }
+        if (lossless) {
+            *str += "#include <algorithm>\n";
+        }
+        if (langData->options.toSourceParallel) {
+            if (measure) {
+                printf("ToSource parallel and measure options can't be combined\n");
+                exit(1);
+            }
+            *str += "#include <thread>\n";
+            *str += "#include <atomic>\n";
+        }
         string className = langData->langKey + "ToSource";
         *str += "class " + className + " ";
         *str += ": public " + langData->langKey + "Visitor {\n";
         *str += "public:\n";
-        *str += "    std::string str;\n";
+        if (langData->options.toSourceSink) {
+            *str += "    SourceSink *sink;\n";
+            *str += "    " + className + "(SourceSink *sink) : sink(sink) {}\n";
+            *str += "    void out(const char *data, size_t len) { sink->write(data, len); }\n";
+            *str += "    void out(const std::string &s) { sink->write(s.data(), s.size()); }\n";
+        } else if (measure) {
+            generateMeasureMembers(str);
+        } else {
+            *str += "    std::string str;\n";
+        }
+        if (lossless) {
+            generateLosslessMembers(str);
+        }
+        if (langData->options.toSourceParallel) {
+            generateParallelMembers(str, className);
+        }
+        if (renderCache) {
+            generateRenderCacheMembers(str);
+        }
         // Gather cases in grammar
         ToSourceGenVisitor caseVisitor = ToSourceGenVisitor(langData);
         caseVisitor.visitSource(source);
         // Add declarations for key methods
         // Class methods defined in visitor base
-        for (auto const &astType : langData->astGrammarTypes) {
-            string astClass = astType.second->astClass;
-            *str += "    void astKey_" + astType.first + "(" + astClass + " *node);\n";
-        }
-        for (auto const &listType : langData->listGrammarTypes) {
-            *str += "    void listKey_" + listType.first + "(std::vector<";
-            listType.second->type->generateGrammarType(str, langData);
-            *str += "> *list);\n"; 
+        generateToSourceKeyDecls(str, "void ", "");
+        if (langData->options.toSourceParallel) {
+            for (auto const &listType : langData->listGrammarTypes) {
+                string elemType;
+                listType.second->type->generateGrammarType(&elemType, langData);
+                *str += "    void listElem_" + listType.first + "(" + listClass(elemType) + " *list, size_t i);\n";
+            }
         }
         // Class visit decls
         for (auto const &classCase : caseVisitor.classCases) {
             *str += "    void visit" + classCase.first + "(" + classCase.first + " *node);\n";
         }
+        if (measure) {
+            generateToSourceKeyDecls(str, "size_t ", "measure_");
+            // Measure all classes, those without case
+            // as done by the visitor base
+            for (auto const &astClass : langData->astClasses) {
+                *str += "    size_t measure_visit" + astClass.first + "(" + astClass.first + " *node);\n";
+            }
+        }
         *str += "};\n\n";
         // Go through ast types and list types
         // and generate methods to ToSource these.
         for (auto const &astType : langData->astGrammarTypes) {
-            bool isClassKey = astType.first == astType.second->astClass;
-            // Maybe skip those with class key
-            string astClass = astType.second->astClass;
-            *str += "void " + className + "::astKey_" + astType.first + "(" + astClass + " *node) {\n";
-            // Switch and pass to class visitor
-            *str += "    switch (node->nodeType) {\n";
-            for (AstRuleDef *ruleDef : astType.second->ruleDefs) {
-                if (ruleDef->refType != nullptr) {
-                    set<string> *classes = new set<string>();
-                    set<string> *visited = new set<string>();
-                    collectAstClasses(ruleDef->refType->identifier, classes, visited);
-                    for (string classCase : *classes) {
-                        *str += "        case " + classCase + "Node:\n";
-                    }
-                    *str += "        astKey_" + ruleDef->refType->identifier + "(static_cast<" + ruleDef->refType->astClass + "*>(node));break;\n";
-                } else {
-                    if (caseVisitor.keyedCases[astType.first][ruleDef->astClass].size() > 1) {
-                        printf("Multiple ast cases not implemented");
-                        exit(1);
-                    }
-                    *str += "        case " + ruleDef->astClass + "Node: ";
-                    *str += "visit" + ruleDef->astClass + "(static_cast<" + ruleDef->astClass + "*>(node));break;\n";
-                }
-            }
-            *str += "    }\n}\n";
+            generateToSourceAstKey(str, className, astType.second, &caseVisitor, false);
+            if (measure) generateToSourceAstKey(str, className, astType.second, &caseVisitor, true);
         }
         // List types
         for (auto const &listType : langData->listGrammarTypes) {
-            *str += "void " + className + "::listKey_" + listType.first + "(std::vector<";
-            listType.second->type->generateGrammarType(str, langData);
-            *str += "> *nodes) {\n"; 
-            *str += "    for (";
-            listType.second->type->generateGrammarType(str, langData);
-            *str += " node : *nodes) {\n";
-            if (listType.second->sepBetween) {
-                *str += "        if (node != nodes->front()) {\n";
-                *str += "            str += \"";
-                if (listType.second->sep->type == PTOKEN) {
-                    TypedPartToken *sep = static_cast<TypedPartToken*>(listType.second->sep);
-                    *str += sep->getCleanedVal(langData);
-                } else {
-                    printf("Only token separator supported\n");
-                    exit(1);
-                }
-                *str += "\";\n        }\n";
-            }
-            *str += "        switch (node->nodeType) {\n";
-            for (ListRuleDef *ruleDef : listType.second->ruleDefs) {
-                // Generate code for each ruleDef
-                string astClass;
-                if (ruleDef->astRule != nullptr) {
-                    astClass = ruleDef->astRule->astClass;
-                    if (ruleDef->astRule->refType != nullptr) {
-                        set<string> *classes = new set<string>();
-                        set<string> *visited = new set<string>();
-                        collectAstClasses(ruleDef->astRule->refType->identifier, classes, visited);
-                        for (string classCase : *classes) {
-                            *str += "            case " + classCase + "Node:\n";
-                        }
-                        *str += "            {\n";
-                        *str += "                astKey_" + ruleDef->astRule->refType->identifier;
-                        *str += "(static_cast<" + ruleDef->astRule->refType->astClass + "*>(node));\n";
-                        if (ruleDef->sepAfter != nullptr) {
-                            if (ruleDef->sepAfter->type == PTOKEN) {
-                                TypedPartToken *sepAfter = static_cast<TypedPartToken*>(ruleDef->sepAfter);
-                                *str += "                str += \"" + sepAfter->getCleanedVal(langData) + "\";\n";
-                            } else {
-                                printf("Only tokens supported as separators\n");
-                                exit(1);
-                            }
-                        }
-                    } else {
-                        if (caseVisitor.keyedCases[listType.first][astClass].size() > 1) {
-                            printf("Multiple cases not supported yet\n");
-                            exit(1);
-                        }
-                        *str += "            case " + astClass + "Node: {\n";
-                        *str += "                visit" + astClass + "(static_cast<" + astClass + "*>(node));\n";
-                        if (ruleDef->sepAfter != nullptr) {
-                            if (ruleDef->sepAfter->type == PTOKEN) {
-                                TypedPartToken *sepAfter = static_cast<TypedPartToken*>(ruleDef->sepAfter);
-                                *str += "                str += \"" + sepAfter->getCleanedVal(langData) + "\";\n";
-                            } else {
-                                printf("Only tokens supported as separators\n");
-                                exit(1);
-                            }
-                        }
-                    }
-                }
-                *str += "                break;\n            }\n";
-            }
-            // Close switch, for loop and function
-            *str += "        }\n    }\n}\n";
+            generateToSourceListKey(str, className, listType.second, &caseVisitor, false);
+            if (measure) generateToSourceListKey(str, className, listType.second, &caseVisitor, true);
         }
         // Add all classes from visitor
         for (auto const &classCase : caseVisitor.classCases) {
             *str += "void " + className + "::visit" + classCase.first + "(" + classCase.first + " *node) {\n";
             if (classCase.second.size() == 1) {
+                if (lossless) {
+                    // Unchanged nodes are copied from source, and
+                    // those with edits below spliced
+                    *str += "    if (syntax != nullptr) {\n"
+                            "        childTrivia(node);\n"
+                            "        if (node->endOffset != 0 && !node->edited) {\n"
+                            "            if (!node->editedBelow) {\n"
+                            "                str.append(syntax->text, node->startOffset, node->endOffset - node->startOffset);\n"
+                            "                return;\n"
+                            "            }\n"
+                            "            if (spliceEdited(node)) return;\n"
+                            "        }\n"
+                            "    }\n";
+                }
+                if (renderCache) {
+                    // Splice in cached source of clean nodes,
+                    // otherwise render and save to the cache
+                    *str += "    addChildPiece(node);\n"
+                            "    if (!node->renderDirty) {\n"
+                            "        appendCached(node);\n"
+                            "        resumeParent();\n"
+                            "        return;\n"
+                            "    }\n"
+                            "    node->renderCache.clear();\n"
+                            "    rendering.push_back(std::make_pair(node, str.size()));\n";
+                }
+                if (lossless) {
+                    *str += "    beginTokens(node);\n";
+                }
                 *str += classCase.second[0]->code;
+                if (lossless) {
+                    *str += "    endTokens();\n";
+                }
+                if (renderCache) {
+                    *str += "    endTextPiece();\n"
+                            "    rendering.pop_back();\n"
+                            "    node->renderDirty = false;\n"
+                            "    resumeParent();\n";
+                }
                 *str += "\n";
             } else {
                 // Several cases
@@ -466,8 +2361,1448 @@ public:
             }
             *str += "}\n";
         }
+        if (measure) {
+            for (auto const &astClass : langData->astClasses) {
+                generateMeasureVisit(str, className, astClass.second, &caseVisitor);
+            }
+        }
+        if (lossless) {
+            generateVisitNode(str, className, &caseVisitor);
+        }
         saveToFile(str, "gen/" + langData->langKey + "ToSource.hpp");
     }
+
+    void generateToSourceKeyDecls(string *str, string retType, string prefix) {
+        for (auto const &astType : langData->astGrammarTypes) {
+            string astClass = astType.second->astClass;
+            *str += "    " + retType + prefix + "astKey_" + astType.first + "(" + astClass + " *node);\n";
+        }
+        for (auto const &listType : langData->listGrammarTypes) {
+            string elemType;
+            listType.second->type->generateGrammarType(&elemType, langData);
+            *str += "    " + retType + prefix + "listKey_" + listType.first + "(" + listClass(elemType) + " *list);\n";
+        }
+    }
+
+    // Statement for call in ToSource, or in the
+    // measure pass, adding up the length instead
+    string toSourceCall(string method, string arg, bool measure) {
+        if (measure) return "len += measure_" + method + "(" + arg + ");";
+        return method + "(" + arg + ");";
+    }
+    string toSourceLiteral(string literal, bool measure) {
+        if (measure) return "len += " + std::to_string(literal.size()) + ";";
+        return ToSourceCase::literalOutput(langData, literal);
+    }
+
+    void generateToSourceAstKey(string *str, string className, AstGrammarType *astType,
+                                ToSourceGenVisitor *caseVisitor, bool measure) {
+        string astClass = astType->astClass;
+        string indent = "        ";
+        if (measure) {
+            *str += "size_t " + className + "::measure_astKey_" + astType->key + "(" + astClass + " *node) {\n";
+            *str += "    size_t len = 0;\n";
+        } else {
+            *str += "void " + className + "::astKey_" + astType->key + "(" + astClass + " *node) {\n";
+        }
+        // Switch and pass to class visitor
+        *str += "    switch (node->nodeType) {\n";
+        for (AstRuleDef *ruleDef : astType->ruleDefs) {
+            if (ruleDef->refType != nullptr) {
+                set<string> *classes = new set<string>();
+                set<string> *visited = new set<string>();
+                collectAstClasses(ruleDef->refType->identifier, classes, visited);
+                for (string classCase : *classes) {
+                    *str += "        case " + classCase + "Node:\n";
+                }
+                *str += indent + toSourceCall("astKey_" + ruleDef->refType->identifier,
+                    "static_cast<" + ruleDef->refType->astClass + "*>(node)", measure) + "break;\n";
+            } else {
+                if (caseVisitor->keyedCases[astType->key][ruleDef->astClass].size() > 1) {
+                    printf("Multiple ast cases not implemented");
+                    exit(1);
+                }
+                *str += "        case " + ruleDef->astClass + "Node: ";
+                *str += toSourceCall("visit" + ruleDef->astClass,
+                    "static_cast<" + ruleDef->astClass + "*>(node)", measure) + "break;\n";
+            }
+        }
+        *str += "    }\n";
+        if (measure) *str += "    return len;\n";
+        *str += "}\n";
+    }
+
+    void generateToSourceListKey(string *str, string className, ListGrammarType *listType,
+                                 ToSourceGenVisitor *caseVisitor, bool measure) {
+        string elemType;
+        listType->type->generateGrammarType(&elemType, langData);
+        string listArg = "(" + listClass(elemType) + " *nodes)";
+        if (langData->options.toSourceParallel && !measure) {
+            generateToSourceParallelList(str, className, listType, caseVisitor);
+            return;
+        }
+        if (measure) {
+            *str += "size_t " + className + "::measure_listKey_" + listType->key + listArg + " {\n";
+            *str += "    size_t len = 0;\n";
+        } else {
+            *str += "void " + className + "::listKey_" + listType->key + listArg + " {\n";
+        }
+        if (langData->isSpillList(listType->key)) {
+            // Spilled items are null and left out,
+            // separators go between those rendered
+            if (listType->sepBetween) *str += "    size_t rendered = 0;\n";
+            *str += "    for (" + elemType + " node : *nodes) {\n";
+            *str += "        if (node == nullptr) continue;\n";
+            *str += toSourceListElem(listType, caseVisitor, measure, "rendered++ > 0");
+            *str += "    }\n";
+            if (measure) *str += "    return len;\n";
+            *str += "}\n";
+            return;
+        }
+        // By index, as shared nodes may repeat in a list
+        *str += "    for (size_t i = 0; i < nodes->size(); ++i) {\n";
+        *str += "        " + elemType + " node = (*nodes)[i];\n";
+        *str += toSourceListElem(listType, caseVisitor, measure, "i > 0");
+        *str += "    }\n";
+        if (measure) *str += "    return len;\n";
+        *str += "}\n";
+    }
+
+    // Code for one list element, with separator
+    // before when isNotFirst holds.
+    string toSourceListElem(ListGrammarType *listType, ToSourceGenVisitor *caseVisitor,
+                            bool measure, string isNotFirst) {
+        string elem;
+        string *str = &elem;
+        string indent = "                ";
+        if (listType->sepBetween) {
+            *str += "        if (" + isNotFirst + ") {\n";
+            if (listType->sep->type == PTOKEN) {
+                TypedPartToken *sep = static_cast<TypedPartToken*>(listType->sep);
+                *str += "            " + toSourceLiteral(sep->getCleanedVal(langData), measure) + "\n";
+            } else {
+                printf("Only token separator supported\n");
+                exit(1);
+            }
+            *str += "        }\n";
+        }
+        *str += "        switch (node->nodeType) {\n";
+        for (ListRuleDef *ruleDef : listType->ruleDefs) {
+            // Generate code for each ruleDef
+            string astClass;
+            if (ruleDef->astRule != nullptr) {
+                astClass = ruleDef->astRule->astClass;
+                if (ruleDef->astRule->refType != nullptr) {
+                    set<string> *classes = new set<string>();
+                    set<string> *visited = new set<string>();
+                    collectAstClasses(ruleDef->astRule->refType->identifier, classes, visited);
+                    for (string classCase : *classes) {
+                        *str += "            case " + classCase + "Node:\n";
+                    }
+                    *str += "            {\n";
+                    *str += indent + toSourceCall("astKey_" + ruleDef->astRule->refType->identifier,
+                        "static_cast<" + ruleDef->astRule->refType->astClass + "*>(node)", measure) + "\n";
+                } else {
+                    if (caseVisitor->keyedCases[listType->key][astClass].size() > 1) {
+                        printf("Multiple cases not supported yet\n");
+                        exit(1);
+                    }
+                    *str += "            case " + astClass + "Node: {\n";
+                    *str += indent + toSourceCall("visit" + astClass,
+                        "static_cast<" + astClass + "*>(node)", measure) + "\n";
+                }
+                if (ruleDef->sepAfter != nullptr) {
+                    if (ruleDef->sepAfter->type == PTOKEN) {
+                        TypedPartToken *sepAfter = static_cast<TypedPartToken*>(ruleDef->sepAfter);
+                        *str += indent + toSourceLiteral(sepAfter->getCleanedVal(langData), measure) + "\n";
+                    } else {
+                        printf("Only tokens supported as separators\n");
+                        exit(1);
+                    }
+                }
+            }
+            *str += "                break;\n            }\n";
+        }
+        // Close switch
+        *str += "        }\n";
+        return elem;
+    }
+
+    // List rendered element by element through listElem_,
+    // splitting large lists into ranges rendered on
+    // worker threads. Each element writes the separator
+    // before it, so ranges concatenate in order.
+    void generateToSourceParallelList(string *str, string className, ListGrammarType *listType,
+                                      ToSourceGenVisitor *caseVisitor) {
+        string elemType;
+        listType->type->generateGrammarType(&elemType, langData);
+        string listArg = listClass(elemType) + " *nodes";
+        *str += "void " + className + "::listKey_" + listType->key + "(" + listArg + ") {\n";
+        *str += "    if (nodes->size() >= parallelThreshold) {\n";
+        *str += "        renderParallel(nodes->size(), [nodes](" + className + " &part, size_t from, size_t to) {\n";
+        *str += "            for (size_t i = from; i < to; ++i) part.listElem_" + listType->key + "(nodes, i);\n";
+        *str += "        });\n";
+        *str += "        return;\n";
+        *str += "    }\n";
+        *str += "    for (size_t i = 0; i < nodes->size(); ++i) listElem_" + listType->key + "(nodes, i);\n";
+        *str += "}\n";
+        *str += "void " + className + "::listElem_" + listType->key + "(" + listArg + ", size_t i) {\n";
+        *str += "    " + elemType + " node = (*nodes)[i];\n";
+        // Dedent loop body to function level
+        string elem = toSourceListElem(listType, caseVisitor, false, "i > 0");
+        size_t pos = 0;
+        while ((pos = elem.find("\n    ", pos)) != string::npos) {
+            elem.erase(pos + 1, 4);
+            pos += 1;
+        }
+        *str += elem.substr(4);
+        *str += "}\n";
+    }
+
+    // Nodes with edits below are spliced from source.
+    // Edited nodes are rendered from the ast, with
+    // a cursor over their source tokens giving the
+    // trivia before each token and child.
+    void generateLosslessMembers(string *str) {
+        *str += "    // Source of parsed nodes, when set\n"
+                "    const SyntaxTree *syntax = nullptr;\n"
+                "    // Next source token of a node rendered from the\n"
+                "    // ast, and its end. Empty for new nodes.\n"
+                "    struct TriviaCursor {\n"
+                "        size_t token;\n"
+                "        size_t end;\n"
+                "    };\n"
+                "    std::vector<TriviaCursor> cursors;\n"
+                "    void visitNode(AstNode *node);\n"
+                "    // First token at or after offset\n"
+                "    size_t tokenFrom(uint32_t offset) {\n"
+                "        if (offset >= syntax->text.size()) return syntax->tokens.size();\n"
+                "        size_t i = syntax->tokenAt(offset);\n"
+                "        return (syntax->tokens[i].start < offset) ? i + 1 : i;\n"
+                "    }\n"
+                "    void beginTokens(AstNode *node) {\n"
+                "        if (syntax == nullptr || node->endOffset == 0) {\n"
+                "            cursors.push_back(TriviaCursor{0, 0});\n"
+                "        } else {\n"
+                "            cursors.push_back(TriviaCursor{tokenFrom(node->startOffset), tokenFrom(node->endOffset)});\n"
+                "        }\n"
+                "    }\n"
+                "    // Trivia ending the range, as the root has\n"
+                "    void endTokens() {\n"
+                "        TriviaCursor cursor = cursors.back();\n"
+                "        cursors.pop_back();\n"
+                "        size_t i = cursor.end;\n"
+                "        while (i > cursor.token && syntax->isTrivia(i - 1)) --i;\n"
+                "        if (i < cursor.end) {\n"
+                "            uint32_t start = syntax->tokens[i].start;\n"
+                "            str.append(syntax->text, start, syntax->tokenEnd(cursor.end - 1) - start);\n"
+                "        }\n"
+                "    }\n"
+                "    // Trivia run before token i, not yet passed\n"
+                "    void triviaBefore(TriviaCursor &cursor, size_t i) {\n"
+                "        size_t first = i;\n"
+                "        while (first > cursor.token && syntax->isTrivia(first - 1)) --first;\n"
+                "        uint32_t start = syntax->tokens[first].start;\n"
+                "        str.append(syntax->text, start, syntax->tokens[i].start - start);\n"
+                "    }\n"
+                "    // Trivia before the next token matching literal,\n"
+                "    // or before the next token when null\n"
+                "    void tokenTrivia(const char *literal, size_t len) {\n"
+                "        if (syntax == nullptr || cursors.empty()) return;\n"
+                "        TriviaCursor &cursor = cursors.back();\n"
+                "        size_t i = cursor.token;\n"
+                "        for (; i < cursor.end; ++i) {\n"
+                "            if (syntax->isTrivia(i)) continue;\n"
+                "            if (literal == nullptr) break;\n"
+                "            uint32_t start = syntax->tokens[i].start;\n"
+                "            if (syntax->tokenEnd(i) - start == len && syntax->text.compare(start, len, literal) == 0) break;\n"
+                "        }\n"
+                "        if (i == cursor.end) return;\n"
+                "        triviaBefore(cursor, i);\n"
+                "        cursor.token = i + 1;\n"
+                "    }\n"
+                "    // Whitespace token, taken from trivia when\n"
+                "    // the source has it\n"
+                "    void spaceTrivia() {\n"
+                "        if (syntax != nullptr && !cursors.empty()) {\n"
+                "            TriviaCursor &cursor = cursors.back();\n"
+                "            size_t i = cursor.token;\n"
+                "            while (i < cursor.end && syntax->isTrivia(i)) ++i;\n"
+                "            if (i > cursor.token) {\n"
+                "                triviaBefore(cursor, i);\n"
+                "                cursor.token = i;\n"
+                "                return;\n"
+                "            }\n"
+                "        }\n"
+                "        str += \" \";\n"
+                "    }\n"
+                "    // Trivia before a child from source, which moves\n"
+                "    // the cursor past it. New children take the place\n"
+                "    // of the next token.\n"
+                "    void childTrivia(AstNode *node) {\n"
+                "        if (cursors.empty()) return;\n"
+                "        if (node->endOffset == 0) {\n"
+                "            tokenTrivia(nullptr, 0);\n"
+                "            return;\n"
+                "        }\n"
+                "        TriviaCursor &cursor = cursors.back();\n"
+                "        size_t i = tokenFrom(node->startOffset);\n"
+                "        if (i < cursor.token || i >= cursor.end) return;\n"
+                "        triviaBefore(cursor, i);\n"
+                "        cursor.token = tokenFrom(node->endOffset);\n"
+                "    }\n"
+                "    // Source of node, with the children having edits\n"
+                "    // rendered in place. False when a child has no\n"
+                "    // source, so the node is rendered from the ast.\n"
+                "    bool spliceEdited(AstNode *node) {\n"
+                "        std::vector<AstNode*> changed;\n"
+                "        bool fromSource = true;\n"
+                "        forEachChild(node, [&](AstNode *child) {\n"
+                "            if (child->endOffset == 0) fromSource = false;\n"
+                "            else if (child->edited || child->editedBelow) changed.push_back(child);\n"
+                "        });\n"
+                "        if (!fromSource) return false;\n"
+                "        std::sort(changed.begin(), changed.end(), [](AstNode *a, AstNode *b) {\n"
+                "            return a->startOffset < b->startOffset;\n"
+                "        });\n"
+                "        uint32_t pos = node->startOffset;\n"
+                "        cursors.push_back(TriviaCursor{0, 0});\n"
+                "        for (AstNode *child : changed) {\n"
+                "            str.append(syntax->text, pos, child->startOffset - pos);\n"
+                "            visitNode(child);\n"
+                "            pos = child->endOffset;\n"
+                "        }\n"
+                "        cursors.pop_back();\n"
+                "        str.append(syntax->text, pos, node->endOffset - pos);\n"
+                "        return true;\n"
+                "    }\n";
+    }
+    // Dispatch on nodeType to the class visits
+    void generateVisitNode(string *str, string className, ToSourceGenVisitor *caseVisitor) {
+        *str += "void " + className + "::visitNode(AstNode *node) {\n"
+                "    switch (node->nodeType) {\n";
+        for (auto const &classCase : caseVisitor->classCases) {
+            *str += "        case " + classCase.first + "Node: visit" + classCase.first + "(static_cast<" + classCase.first + "*>(node));break;\n";
+        }
+        *str += "        default:break;\n"
+                "    }\n"
+                "}\n";
+    }
+
+    // Render cache pieces are built while rendering dirty
+    // nodes. Text goes to str as usual, and is split at
+    // each child into the node's own pieces. Lists rendered
+    // in parallel are kept as text of the parent.
+    void generateRenderCacheMembers(string *str) {
+        *str += "    // Dirty nodes being rendered, and where\n"
+                "    // their pending text starts in str\n"
+                "    std::vector<std::pair<AstNode*, size_t>> rendering;\n"
+                "    void endTextPiece() {\n"
+                "        std::pair<AstNode*, size_t> &top = rendering.back();\n"
+                "        if (str.size() > top.second) {\n"
+                "            top.first->renderCache.push_back(RenderPiece{str.substr(top.second), nullptr});\n"
+                "        }\n"
+                "    }\n"
+                "    void addChildPiece(AstNode *child) {\n"
+                "        if (rendering.empty()) return;\n"
+                "        endTextPiece();\n"
+                "        rendering.back().first->renderCache.push_back(RenderPiece{std::string(), child});\n"
+                "    }\n"
+                "    void resumeParent() {\n"
+                "        if (!rendering.empty()) rendering.back().second = str.size();\n"
+                "    }\n"
+                "    // Expands pieces of a clean node into str\n"
+                "    void appendCached(AstNode *node) {\n"
+                "        std::vector<std::pair<AstNode*, size_t>> work;\n"
+                "        work.push_back(std::make_pair(node, (size_t)0));\n"
+                "        while (!work.empty()) {\n"
+                "            std::pair<AstNode*, size_t> &top = work.back();\n"
+                "            if (top.second == top.first->renderCache.size()) {\n"
+                "                work.pop_back();\n"
+                "                continue;\n"
+                "            }\n"
+                "            const RenderPiece &piece = top.first->renderCache[top.second++];\n"
+                "            if (piece.child == nullptr) {\n"
+                "                str += piece.text;\n"
+                "            } else {\n"
+                "                work.push_back(std::make_pair(piece.child, (size_t)0));\n"
+                "            }\n"
+                "        }\n"
+                "    }\n";
+    }
+
+    // Members for rendering lists on worker threads.
+    // Each range gets its own ToSource, with output
+    // joined in order after all threads are done.
+    void generateParallelMembers(string *str, string className) {
+        *str += "    // Lists with at least this many elements\n"
+                "    // are rendered in parallel\n"
+                "    size_t parallelThreshold = 4096;\n"
+                "    // Zero uses hardware concurrency\n"
+                "    unsigned numThreads = 0;\n";
+        *str += "    template<typename F>\n"
+                "    void renderParallel(size_t count, F renderRange) {\n"
+                "        unsigned threads = numThreads ? numThreads : std::thread::hardware_concurrency();\n"
+                "        if (threads == 0) threads = 1;\n"
+                "        size_t numRanges = threads * 4;\n"
+                "        if (numRanges > count) numRanges = count;\n"
+                "        std::vector<std::string> parts(numRanges);\n"
+                "        std::atomic<size_t> next(0);\n"
+                "        auto work = [&]() {\n"
+                "            size_t range;\n"
+                "            while ((range = next++) < numRanges) {\n";
+        if (langData->options.toSourceSink) {
+            *str += "                StringSink partSink;\n"
+                    "                " + className + " part(&partSink);\n";
+        } else {
+            *str += "                " + className + " part;\n";
+        }
+        if (langData->options.subtreeMask) {
+            *str += "                part.wantedMask = wantedMask;\n";
+        }
+        *str += "                // Nested lists stay on this thread\n"
+                "                part.parallelThreshold = (size_t)-1;\n"
+                "                renderRange(part, count * range / numRanges, count * (range + 1) / numRanges);\n";
+        if (langData->options.toSourceSink) {
+            *str += "                partSink.flush();\n"
+                    "                parts[range] = std::move(partSink.str);\n";
+        } else {
+            *str += "                parts[range] = std::move(part.str);\n";
+        }
+        *str += "            }\n"
+                "        };\n"
+                "        std::vector<std::thread> pool;\n"
+                "        for (unsigned i = 1; i < threads && i < numRanges; ++i) pool.emplace_back(work);\n"
+                "        work();\n"
+                "        for (std::thread &thread : pool) thread.join();\n";
+        if (langData->options.toSourceSink) {
+            *str += "        for (std::string &part : parts) out(part);\n";
+        } else {
+            *str += "        size_t total = str.size();\n"
+                    "        for (std::string &part : parts) total += part.size();\n"
+                    "        str.reserve(total);\n"
+                    "        for (std::string &part : parts) str += part;\n";
+        }
+        *str += "    }\n";
+    }
+
+    // Members for rendering into a buffer
+    // sized by the measure pass
+    void generateMeasureMembers(string *str) {
+        string startType;
+        langData->startAction->startPart->generateGrammarType(&startType, langData);
+        string startCall;
+        if (langData->startAction->startPart->type == PAST) {
+            startCall = "astKey_" + langData->startKey;
+        } else if (langData->startAction->startPart->type == PLIST) {
+            startCall = "listKey_" + langData->startKey;
+        } else {
+            printf("Measure needs ast or list as start\n");
+            exit(1);
+        }
+        *str += "    // Current position in render buffer\n"
+                "    char *pos;\n"
+                "    void out(const char *data, size_t len) {\n"
+                "        memcpy(pos, data, len);\n"
+                "        pos += len;\n"
+                "    }\n"
+                "    void out(const std::string &s) { out(s.data(), s.size()); }\n"
+                "    template<typename T>\n"
+                "    static size_t intLength(T val) {\n"
+                "        size_t len = (val < 0) ? 2 : 1;\n"
+                "        unsigned long long u = (val < 0) ? 0ULL - (unsigned long long)val : (unsigned long long)val;\n"
+                "        while (u >= 10) {\n"
+                "            u /= 10;\n"
+                "            ++len;\n"
+                "        }\n"
+                "        return len;\n"
+                "    }\n";
+        *str += "    size_t measure(" + startType + " node) {\n"
+                "        return measure_" + startCall + "(node);\n"
+                "    }\n";
+        *str += "    // Buffer must hold measure(node) bytes\n"
+                "    void renderTo(" + startType + " node, char *buffer) {\n"
+                "        pos = buffer;\n"
+                "        " + startCall + "(node);\n"
+                "    }\n";
+        *str += "    std::string render(" + startType + " node) {\n"
+                "        std::string result(measure(node), '\\0');\n"
+                "        if (result.size() > 0) renderTo(node, &result[0]);\n"
+                "        return result;\n"
+                "    }\n";
+    }
+
+    // Measure for a class, from its ToSource case, or
+    // following the visitor base when there is none
+    void generateMeasureVisit(string *str, string className, AstClass *astClass, ToSourceGenVisitor *caseVisitor) {
+        string identifier = astClass->identifier;
+        *str += "size_t " + className + "::measure_visit" + identifier + "(" + identifier + " *node) {\n";
+        *str += "    size_t len = 0;\n";
+        if (caseVisitor->classCases.count(identifier) != 0) {
+            *str += caseVisitor->classCases[identifier][0]->measureCode;
+        } else if (astClass->subClasses.size() > 0) {
+            *str += "    switch(node->nodeType) {\n";
+            for (string subClass : astClass->subClasses) {
+                *str += "        case " + subClass + "Node: ";
+                *str += "len += measure_visit" + subClass + "(static_cast<" + subClass + "*>(node));break;\n";
+            }
+            *str += "        default:break;\n";
+            *str += "    }\n";
+        } else {
+            for (auto const &member : astClass->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    TypedPartAst *astPart = static_cast<TypedPartAst*>(typedPart);
+                    *str += "    len += measure_visit" + astPart->astClass + "(node->" + member.first + ");\n";
+                } else if (typedPart->type == PLIST) {
+                    TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+                    if (listType->type->type != PAST) continue;
+                    TypedPartAst *listAstPart = static_cast<TypedPartAst*>(listType->type);
+                    *str += "    for (";
+                    listType->type->generateGrammarType(str, langData);
+                    *str += " child : *" + listPtr("node", member.first) + ") {\n";
+                    *str += "        len += measure_visit" + listAstPart->astClass + "(child);\n";
+                    *str += "    }\n";
+                }
+            }
+        }
+        *str += "    return len;\n";
+        *str += "}\n";
+    }
+
+    // Sinks for ToSource output. Writes are copied into
+    // a fixed size chunk, which is handed to the target
+    // when full, so memory use stays bounded.
+    void generateSourceSinks(string *str) {
+        *str += "#include <string.h>\n"
+                "#include <errno.h>\n"
+                "#include <ostream>\n"
+                "#include <functional>\n"
+                "#ifdef _WIN32\n"
+                "#include <io.h>\n"
+                "#else\n"
+                "#include <unistd.h>\n"
+                "#endif\n";
+        *str += "class SourceSink {\n"
+                "public:\n"
+                "    SourceSink(size_t capacity = 64 * 1024) : chunk(capacity), used(0) {}\n"
+                "    SourceSink(const SourceSink&) = delete;\n"
+                "    SourceSink& operator=(const SourceSink&) = delete;\n"
+                "    virtual ~SourceSink() {}\n"
+                "    void write(const char *data, size_t len) {\n"
+                "        if (len > chunk.size() - used) {\n"
+                "            flush();\n"
+                "            // Larger than a chunk, pass directly\n"
+                "            if (len >= chunk.size()) {\n"
+                "                writeChunk(data, len);\n"
+                "                return;\n"
+                "            }\n"
+                "        }\n"
+                "        memcpy(chunk.data() + used, data, len);\n"
+                "        used += len;\n"
+                "    }\n"
+                "    void flush() {\n"
+                "        if (used > 0) {\n"
+                "            writeChunk(chunk.data(), used);\n"
+                "            used = 0;\n"
+                "        }\n"
+                "    }\n"
+                "protected:\n"
+                "    std::vector<char> chunk;\n"
+                "    size_t used;\n"
+                "    virtual void writeChunk(const char *data, size_t len) = 0;\n"
+                "};\n";
+        // Collects into a string
+        *str += "class StringSink : public SourceSink {\n"
+                "public:\n"
+                "    std::string str;\n"
+                "    ~StringSink() { flush(); }\n"
+                "protected:\n"
+                "    void writeChunk(const char *data, size_t len) { str.append(data, len); }\n"
+                "};\n";
+        // File descriptor
+        *str += "class FdSink : public SourceSink {\n"
+                "public:\n"
+                "    int fd;\n"
+                "    FdSink(int fd, size_t capacity = 64 * 1024) : SourceSink(capacity), fd(fd) {}\n"
+                "    ~FdSink() { flush(); }\n"
+                "protected:\n"
+                "    void writeChunk(const char *data, size_t len) {\n"
+                "        while (len > 0) {\n"
+                "            #ifdef _WIN32\n"
+                "            int written = _write(fd, data, (unsigned int)len);\n"
+                "            #else\n"
+                "            ssize_t written = ::write(fd, data, len);\n"
+                "            #endif\n"
+                "            // Interrupted by a signal before writing\n"
+                "            if (written < 0 && errno == EINTR) continue;\n"
+                "            if (written <= 0) {\n"
+                "                printf(\"Write to fd %d failed\\n\", fd);\n"
+                "                exit(1);\n"
+                "            }\n"
+                "            data += written;\n"
+                "            len -= written;\n"
+                "        }\n"
+                "    }\n"
+                "};\n";
+        // Stream
+        *str += "class OStreamSink : public SourceSink {\n"
+                "public:\n"
+                "    std::ostream &os;\n"
+                "    OStreamSink(std::ostream &os, size_t capacity = 64 * 1024) : SourceSink(capacity), os(os) {}\n"
+                "    ~OStreamSink() { flush(); }\n"
+                "protected:\n"
+                "    void writeChunk(const char *data, size_t len) { os.write(data, len); }\n"
+                "};\n";
+        // User callback
+        *str += "class CallbackSink : public SourceSink {\n"
+                "public:\n"
+                "    std::function<void(const char*, size_t)> callback;\n"
+                "    CallbackSink(std::function<void(const char*, size_t)> callback, size_t capacity = 64 * 1024)\n"
+                "        : SourceSink(capacity), callback(callback) {}\n"
+                "    ~CallbackSink() { flush(); }\n"
+                "protected:\n"
+                "    void writeChunk(const char *data, size_t len) { callback(data, len); }\n"
+                "};\n";
+    }
+    // Type of the start rule, and names of
+    // generated methods handling it
+    string startType() {
+        string type;
+        langData->startAction->startPart->generateGrammarType(&type, langData);
+        return type;
+    }
+    string listElemClass(TypedPart *typedPart) {
+        TypedPartList *listType = static_cast<TypedPartList*>(typedPart);
+        if (listType->type->type != PAST) {
+            printf("Only lists of ast supported\n");
+            exit(1);
+        }
+        return static_cast<TypedPartAst*>(listType->type)->astClass;
+    }
+
+    // Binary format for ast trees:
+    // magic, string table, then nodes in preorder.
+    // Nodes are varint nodeType + 1 (0 for null) followed
+    // by members in declaration order. Integers are
+    // zigzag varints, enums varints, strings varint
+    // indexes into the table and lists varint length + 1.
+    void generateSerializer() {
+        string *str = new string;
+        string writerName = langData->langKey + "Serializer";
+        string readerName = langData->langKey + "Deserializer";
+        TypedPart *startPart = langData->startAction->startPart;
+        *str += "#pragma once\n";
+        *str += "#include \"" + langData->langKey + ".hpp\"\n";
+        *str += "#include <string>\n"
+                "#include <vector>\n"
+                "#include <unordered_map>\n"
+                "#include <string.h>\n"
+                "#include <stdint.h>\n"
+                "#include <stdio.h>\n";
+        *str += "static const char " + langData->langKey + "BinMagic[4] = {'L', 'B', 'S', '1'};\n";
+        // Writer
+        *str += "class " + writerName + " {\n"
+                "public:\n"
+                "    std::string nodes;\n"
+                "    std::vector<std::string> strings;\n"
+                "    std::unordered_map<std::string, uint32_t> stringIds;\n"
+                "    static void writeVarint(std::string *out, uint64_t val) {\n"
+                "        while (val >= 0x80) {\n"
+                "            *out += (char)(val | 0x80);\n"
+                "            val >>= 7;\n"
+                "        }\n"
+                "        *out += (char)val;\n"
+                "    }\n"
+                "    void writeVarint(uint64_t val) { writeVarint(&nodes, val); }\n"
+                "    void writeInt(long long val) {\n"
+                "        writeVarint(((uint64_t)val << 1) ^ (uint64_t)(val >> 63));\n"
+                "    }\n"
+                "    void writeDouble(double val) {\n"
+                "        char bytes[8];\n"
+                "        memcpy(bytes, &val, 8);\n"
+                "        nodes.append(bytes, 8);\n"
+                "    }\n"
+                "    void writeString(const std::string &val) {\n"
+                "        auto it = stringIds.find(val);\n"
+                "        if (it != stringIds.end()) {\n"
+                "            writeVarint(it->second);\n"
+                "            return;\n"
+                "        }\n"
+                "        uint32_t id = (uint32_t)strings.size();\n"
+                "        stringIds.emplace(val, id);\n"
+                "        strings.push_back(val);\n"
+                "        writeVarint(id);\n"
+                "    }\n"
+                "    template<typename L>\n"
+                "    void writeList(L *list) {\n"
+                "        if (list == nullptr) {\n"
+                "            writeVarint(0);\n"
+                "            return;\n"
+                "        }\n"
+                "        writeVarint(list->size() + 1);\n"
+                "        for (AstNode *node : *list) writeNode(node);\n"
+                "    }\n";
+        *str += "    void writeNode(AstNode *node) {\n"
+                "        if (node == nullptr) {\n"
+                "            writeVarint(0);\n"
+                "            return;\n"
+                "        }\n"
+                "        writeVarint(node->nodeType + 1);\n"
+                "        switch (node->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            *str += "            case " + astClass.first + "Node: ";
+            *str += "write" + astClass.first + "(static_cast<" + astClass.first + "*>(node));break;\n";
+        }
+        *str += "            default:break;\n"
+                "        }\n"
+                "    }\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            *str += "    void write" + astClass.first + "(" + astClass.first + " *node) {\n";
+            for (auto const &member : astClass.second->members) {
+                *str += "        " + serializeMember(member.second->typedPart, member.first, true) + "\n";
+            }
+            *str += "    }\n";
+        }
+        *str += "    // Header and string table, then nodes\n"
+                "    std::string finish() {\n"
+                "        std::string out(" + langData->langKey + "BinMagic, 4);\n"
+                "        uint64_t fingerprint = " + langData->langKey + "GrammarFingerprint;\n"
+                "        out.append((const char*)&fingerprint, 8);\n"
+                "        writeVarint(&out, strings.size());\n"
+                "        for (const std::string &s : strings) {\n"
+                "            writeVarint(&out, s.size());\n"
+                "            out += s;\n"
+                "        }\n"
+                "        out += nodes;\n"
+                "        return out;\n"
+                "    }\n";
+        *str += "    static std::string serialize(" + startType() + " root) {\n"
+                "        " + writerName + " writer;\n";
+        *str += (startPart->type == PLIST) ? "        writer.writeList(root);\n" : "        writer.writeNode(root);\n";
+        *str += "        return writer.finish();\n"
+                "    }\n";
+        *str += "    static bool saveFile(" + startType() + " root, std::string fileName) {\n"
+                "        std::string data = serialize(root);\n"
+                "        FILE *file = fopen(fileName.c_str(), \"wb\");\n"
+                "        if (!file) return false;\n"
+                "        bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();\n"
+                "        return (fclose(file) == 0) && ok;\n"
+                "    }\n";
+        *str += "};\n";
+        // Reader
+        *str += "// Returns nullptr on malformed input\n";
+        *str += "class " + readerName + " {\n"
+                "public:\n"
+                "    const unsigned char *pos;\n"
+                "    const unsigned char *end;\n"
+                "    bool ok;\n"
+                "    std::vector<std::string> strings;\n"
+                "    " + readerName + "(const char *data, size_t len)\n"
+                "        : pos((const unsigned char*)data), end((const unsigned char*)data + len), ok(true) {}\n"
+                "    uint64_t readVarint() {\n"
+                "        uint64_t val = 0;\n"
+                "        for (int shift = 0; pos < end && shift < 64; shift += 7) {\n"
+                "            unsigned char byte = *pos++;\n"
+                "            val |= (uint64_t)(byte & 0x7f) << shift;\n"
+                "            if (!(byte & 0x80)) return val;\n"
+                "        }\n"
+                "        ok = false;\n"
+                "        return 0;\n"
+                "    }\n"
+                "    long long readInt() {\n"
+                "        uint64_t val = readVarint();\n"
+                "        return (long long)(val >> 1) ^ -(long long)(val & 1);\n"
+                "    }\n"
+                "    double readDouble() {\n"
+                "        double val = 0;\n"
+                "        if (end - pos < 8) {\n"
+                "            ok = false;\n"
+                "            return val;\n"
+                "        }\n"
+                "        memcpy(&val, pos, 8);\n"
+                "        pos += 8;\n"
+                "        return val;\n"
+                "    }\n"
+                "    std::string readString() {\n"
+                "        uint64_t id = readVarint();\n"
+                "        if (id >= strings.size()) {\n"
+                "            ok = false;\n"
+                "            return std::string();\n"
+                "        }\n"
+                "        return strings[id];\n"
+                "    }\n"
+                "    // Next node, which must be of the member or list\n"
+                "    // element class, and present unless optional\n"
+                "    template<typename T>\n"
+                "    T* readChild(bool (*isClass)(NodeType), bool optional) {\n"
+                "        AstNode *node = readNode();\n"
+                "        if (node == nullptr) {\n"
+                "            if (!optional) ok = false;\n"
+                "            return nullptr;\n"
+                "        }\n"
+                "        if (!isClass(node->nodeType)) {\n"
+                "            ok = false;\n"
+                "            destroyTree(node);\n"
+                "            return nullptr;\n"
+                "        }\n"
+                "        return static_cast<T*>(node);\n"
+                "    }\n"
+                "    template<typename T>\n"
+                "    std::vector<T*>* readList(bool (*isElem)(NodeType)) {\n"
+                "        uint64_t len = readVarint();\n"
+                "        if (len == 0 || !ok) return nullptr;\n"
+                "        len -= 1;\n"
+                "        // Each element takes at least a byte\n"
+                "        if (len > (uint64_t)(end - pos)) {\n"
+                "            ok = false;\n"
+                "            return nullptr;\n"
+                "        }\n"
+                "        std::vector<T*> *list = new std::vector<T*>();\n"
+                "        list->reserve(len);\n"
+                "        for (uint64_t i = 0; i < len && ok; ++i) {\n"
+                "            T *elem = readChild<T>(isElem, false);\n"
+                "            if (elem != nullptr) list->push_back(elem);\n"
+                "        }\n"
+                "        return list;\n"
+                "    }\n";
+        // Class checks for children, a class
+        // taking any of its constructed subclasses
+        for (auto const &astClass : langData->astClasses) {
+            set<string> classes;
+            collectConstructedClasses(astClass.first, &classes);
+            if (classes.size() == 0) continue;
+            *str += "    static bool is" + astClass.first + "(NodeType type) {\n"
+                    "        switch (type) {\n";
+            for (string cls : classes) {
+                *str += "            case " + cls + "Node:\n";
+            }
+            *str += "                return true;\n"
+                    "            default:\n"
+                    "                return false;\n"
+                    "        }\n"
+                    "    }\n";
+        }
+        *str += "    AstNode* readNode() {\n"
+                "        uint64_t type = readVarint();\n"
+                "        if (type == 0 || !ok) return nullptr;\n"
+                "        switch (type - 1) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            *str += "            case " + astClass.first + "Node: return read" + astClass.first + "();\n";
+        }
+        *str += "            default:\n"
+                "                ok = false;\n"
+                "                return nullptr;\n"
+                "        }\n"
+                "    }\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            *str += "    " + astClass.first + "* read" + astClass.first + "() {\n";
+            *str += "        " + astClass.first + " *node = new " + astClass.first + "();\n";
+            for (auto const &member : astClass.second->members) {
+                // Null only when left out by some constructor
+                bool optional = !isRequiredMember(astClass.second, member.first);
+                *str += "        " + serializeMember(member.second->typedPart, member.first, false, optional) + "\n";
+            }
+            *str += langData->options.hasFinishNode() ? "        return finishNode(node);\n" : "        return node;\n";
+            *str += "    }\n";
+        }
+        *str += "    " + startType() + " readRoot() {\n";
+        if (startPart->type == PLIST) {
+            string elemClass = listElemClass(startPart);
+            *str += "        return readList<" + elemClass + ">(is" + elemClass + ");\n";
+        } else {
+            string startClass = static_cast<TypedPartAst*>(startPart)->astClass;
+            *str += "        return readChild<" + startClass + ">(is" + startClass + ", false);\n";
+        }
+        *str += "    }\n";
+        *str += "    static " + startType() + " deserialize(const char *data, size_t len) {\n"
+                "        " + readerName + " reader(data, len);\n"
+                "        if (len < 12 || memcmp(data, " + langData->langKey + "BinMagic, 4) != 0) return nullptr;\n"
+                "        uint64_t fingerprint;\n"
+                "        memcpy(&fingerprint, data + 4, 8);\n"
+                "        if (fingerprint != " + langData->langKey + "GrammarFingerprint) return nullptr;\n"
+                "        reader.pos += 12;\n"
+                "        uint64_t numStrings = reader.readVarint();\n"
+                "        if (numStrings > len) return nullptr;\n"
+                "        reader.strings.reserve(numStrings);\n"
+                "        for (uint64_t i = 0; i < numStrings && reader.ok; ++i) {\n"
+                "            uint64_t strLen = reader.readVarint();\n"
+                "            if (strLen > (uint64_t)(reader.end - reader.pos)) return nullptr;\n"
+                "            reader.strings.emplace_back((const char*)reader.pos, strLen);\n"
+                "            reader.pos += strLen;\n"
+                "        }\n"
+                "        " + startType() + " root = reader.readRoot();\n"
+                "        if (!reader.ok) {\n"
+                "            // Partial tree\n"
+                "            destroyTree(root);\n"
+                "            return nullptr;\n"
+                "        }\n"
+                "        return root;\n"
+                "    }\n";
+        *str += "    static " + startType() + " loadFile(std::string fileName) {\n"
+                "        FILE *file = fopen(fileName.c_str(), \"rb\");\n"
+                "        if (!file) return nullptr;\n"
+                "        std::string data;\n"
+                "        char buffer[64 * 1024];\n"
+                "        size_t len;\n"
+                "        while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) data.append(buffer, len);\n"
+                "        fclose(file);\n"
+                "        return deserialize(data.data(), data.size());\n"
+                "    }\n";
+        *str += "};\n";
+        if (langData->options.parseCache) {
+            generateParseCache(str);
+        }
+        saveToFile(str, "gen/" + langData->langKey + "Serializer.hpp");
+    }
+
+    // Parses through a directory of serialized trees,
+    // named by hash of the input bytes and grammar
+    // fingerprint. Stale entries are never hit, as the
+    // fingerprint changes with the .lang file.
+    void generateParseCache(string *str) {
+        string key = langData->langKey;
+        *str += "#include <random>\n";
+        *str += "// Fast non-cryptographic hash, 8 bytes per step\n"
+                "inline uint64_t " + key + "HashBytes(const char *data, size_t len, uint64_t seed) {\n"
+                "    const uint64_t mul = 0x9e3779b97f4a7c15ULL;\n"
+                "    uint64_t hash = seed ^ (len * mul);\n"
+                "    size_t i = 0;\n"
+                "    uint64_t block;\n"
+                "    for (; i + 8 <= len; i += 8) {\n"
+                "        memcpy(&block, data + i, 8);\n"
+                "        block *= mul;\n"
+                "        block ^= block >> 32;\n"
+                "        hash = (hash ^ block) * 0xd6e8feb86659fd93ULL;\n"
+                "        hash ^= hash >> 32;\n"
+                "    }\n"
+                "    block = 0;\n"
+                "    memcpy(&block, data + i, len - i);\n"
+                "    hash = (hash ^ block) * 0xd6e8feb86659fd93ULL;\n"
+                "    hash ^= hash >> 29;\n"
+                "    hash *= 0xbf58476d1ce4e5b9ULL;\n"
+                "    hash ^= hash >> 32;\n"
+                "    return hash;\n"
+                "}\n";
+        *str += "class " + key + "ParseCache {\n"
+                "public:\n"
+                "    static bool readFile(std::string fileName, std::string *data) {\n"
+                "        FILE *file = fopen(fileName.c_str(), \"rb\");\n"
+                "        if (!file) return false;\n"
+                "        char buffer[64 * 1024];\n"
+                "        size_t len;\n"
+                "        while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) data->append(buffer, len);\n"
+                "        fclose(file);\n"
+                "        return true;\n"
+                "    }\n"
+                "    static std::string cacheFile(const std::string &data, std::string cacheDir) {\n"
+                "        uint64_t hash = " + key + "HashBytes(data.data(), data.size(), " + key + "GrammarFingerprint);\n"
+                "        char name[32];\n"
+                "        snprintf(name, sizeof(name), \"%016llx.ast\", (unsigned long long)hash);\n"
+                "        return cacheDir + \"/\" + name;\n"
+                "    }\n"
+                "    // Returns cached tree when input is unchanged,\n"
+                "    // otherwise parses the bytes hashed and stores\n"
+                "    // the tree\n"
+                "    static " + startType() + " parseFile(std::string fileName, std::string cacheDir) {\n"
+                "        std::string data;\n"
+                "        if (!readFile(fileName, &data)) {\n"
+                "            printf(\"Can't open file %s\", fileName.c_str());\n"
+                "            exit(1);\n"
+                "        }\n"
+                "        std::string cached = cacheFile(data, cacheDir);\n"
+                "        " + startType() + " root = " + key + "Deserializer::loadFile(cached);\n"
+                "        if (root != nullptr) return root;\n"
+                "        root = Loader::parseBytes(data.data(), data.size());\n"
+                "        // Write and rename, so readers never\n"
+                "        // see a partial entry\n"
+                "        std::string tmpFile = cached + \".\" + std::to_string(std::random_device()()) + \".tmp\";\n"
+                "        if (" + key + "Serializer::saveFile(root, tmpFile)) {\n"
+                "            if (rename(tmpFile.c_str(), cached.c_str()) != 0) remove(tmpFile.c_str());\n"
+                "        } else {\n"
+                "            remove(tmpFile.c_str());\n"
+                "        }\n"
+                "        return root;\n"
+                "    }\n"
+                "};\n";
+    }
+
+    // Statement writing or reading one member
+    string serializeMember(TypedPart *typedPart, string memberKey, bool write, bool optional = false) {
+        string member = "node->" + memberKey;
+        switch (typedPart->type) {
+            case PSTRING:
+            case PTOKEN:
+            return write ? "writeString(" + member + ");" : member + " = readString();";
+            case PINT: {
+                string intType;
+                typedPart->generateGrammarType(&intType, langData);
+                return write ? "writeInt(" + member + ");" : member + " = (" + intType + ")readInt();";
+            }
+            case PFLOAT:
+            return write ? "writeDouble(" + member + ");" : member + " = readDouble();";
+            case PENUM: {
+                TypedPartEnum *enumPart = static_cast<TypedPartEnum*>(typedPart);
+                return write ? "writeVarint(" + member + ");"
+                    : member + " = static_cast<" + enumPart->enumKey + ">(readVarint());";
+            }
+            case PAST: {
+                TypedPartAst *astPart = static_cast<TypedPartAst*>(typedPart);
+                return write ? "writeNode(" + member + ");"
+                    : member + " = readChild<" + astPart->astClass + ">(is" + astPart->astClass + (optional ? ", true);" : ", false);");
+            }
+            case PLIST: {
+                string elemClass = listElemClass(typedPart);
+                return write ? "writeList(" + listPtr("node", memberKey) + ");"
+                    : member + " = readList<" + elemClass + ">(is" + elemClass + ");";
+            }
+        }
+        return "";
+    }
+    // Class with its subclasses that have constructors
+    void collectConstructedClasses(string className, set<string> *classes) {
+        AstClass *astClass = langData->astClasses[className];
+        if (astClass->constructors.size() > 0) classes->insert(className);
+        for (string subClass : astClass->subClasses) {
+            collectConstructedClasses(subClass, classes);
+        }
+    }
+    // Set by every constructor of the class
+    bool isRequiredMember(AstClass *astClass, string memberKey) {
+        for (AstClassConstructor *constructor : astClass->constructors) {
+            if (std::find(constructor->args.begin(), constructor->args.end(), memberKey) == constructor->args.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Size of a member field in snapshot records
+    size_t snapshotFieldSize(TypedPart *typedPart) {
+        return (typedPart->type == PINT || typedPart->type == PFLOAT) ? 8 : 4;
+    }
+
+    // Position independent snapshot of a tree, to be
+    // mmap'ed and read in place through Snap* views.
+    // Records are 4 byte aligned, starting with the
+    // nodeType, then member fields in declaration order.
+    // Ints and floats take 8 bytes, enums 4, while ast,
+    // string and list fields hold an int32 offset relative
+    // to the field (0 for null). Strings are length + bytes,
+    // lists length + relative offsets. Native byte order.
+    void generateSnapshot() {
+        string *str = new string;
+        string key = langData->langKey;
+        string writerName = key + "SnapshotWriter";
+        TypedPart *startPart = langData->startAction->startPart;
+        *str += "#pragma once\n";
+        *str += "#include \"" + key + ".hpp\"\n";
+        *str += "#include <string>\n"
+                "#include <vector>\n"
+                "#include <unordered_map>\n"
+                "#include <string.h>\n"
+                "#include <stdint.h>\n"
+                "#include <stdio.h>\n"
+                "#ifndef _WIN32\n"
+                "#include <sys/mman.h>\n"
+                "#endif\n";
+        *str += "static const char " + key + "SnapMagic[4] = {'L', 'B', 'M', '1'};\n";
+        // Writer
+        *str += "class " + writerName + " {\n"
+                "public:\n"
+                "    std::string image;\n"
+                "    std::unordered_map<std::string, uint32_t> stringOffsets;\n"
+                "    // Zeroed, 4 byte aligned space\n"
+                "    uint32_t alloc(size_t len) {\n"
+                "        image.append((4 - image.size() % 4) % 4, '\\0');\n"
+                "        uint32_t offset = (uint32_t)image.size();\n"
+                "        image.append(len, '\\0');\n"
+                "        return offset;\n"
+                "    }\n"
+                "    void put32(uint32_t at, uint32_t val) { memcpy(&image[at], &val, 4); }\n"
+                "    void put64(uint32_t at, uint64_t val) { memcpy(&image[at], &val, 8); }\n"
+                "    void putDouble(uint32_t at, double val) { memcpy(&image[at], &val, 8); }\n"
+                "    void putRel(uint32_t at, uint32_t target) {\n"
+                "        int32_t rel = (target == 0) ? 0 : (int32_t)((int64_t)target - at);\n"
+                "        memcpy(&image[at], &rel, 4);\n"
+                "    }\n"
+                "    uint32_t writeString(const std::string &val) {\n"
+                "        auto it = stringOffsets.find(val);\n"
+                "        if (it != stringOffsets.end()) return it->second;\n"
+                "        uint32_t offset = alloc(4 + val.size());\n"
+                "        put32(offset, (uint32_t)val.size());\n"
+                "        memcpy(&image[offset + 4], val.data(), val.size());\n"
+                "        stringOffsets.emplace(val, offset);\n"
+                "        return offset;\n"
+                "    }\n"
+                "    template<typename L>\n"
+                "    uint32_t writeList(L *list) {\n"
+                "        if (list == nullptr) return 0;\n"
+                "        uint32_t offset = alloc(4 + 4 * list->size());\n"
+                "        put32(offset, (uint32_t)list->size());\n"
+                "        for (size_t i = 0; i < list->size(); ++i) {\n"
+                "            putRel(offset + 4 + 4 * (uint32_t)i, writeNode((*list)[i]));\n"
+                "        }\n"
+                "        return offset;\n"
+                "    }\n"
+                "    uint32_t writeNode(AstNode *node) {\n"
+                "        if (node == nullptr) return 0;\n"
+                "        switch (node->nodeType) {\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            *str += "            case " + astClass.first + "Node: ";
+            *str += "return write" + astClass.first + "(static_cast<" + astClass.first + "*>(node));\n";
+        }
+        *str += "            default: return 0;\n"
+                "        }\n"
+                "    }\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            size_t recordSize = 4;
+            for (auto const &member : astClass.second->members) {
+                recordSize += snapshotFieldSize(member.second->typedPart);
+            }
+            *str += "    uint32_t write" + astClass.first + "(" + astClass.first + " *node) {\n";
+            *str += "        uint32_t offset = alloc(" + std::to_string(recordSize) + ");\n";
+            *str += "        put32(offset, " + astClass.first + "Node);\n";
+            size_t fieldOffset = 4;
+            for (auto const &member : astClass.second->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                string at = "offset + " + std::to_string(fieldOffset);
+                string value = "node->" + member.first;
+                switch (typedPart->type) {
+                    case PSTRING:
+                    case PTOKEN:
+                    *str += "        putRel(" + at + ", writeString(" + value + "));\n";
+                    break;
+                    case PINT:
+                    *str += "        put64(" + at + ", (uint64_t)(int64_t)" + value + ");\n";
+                    break;
+                    case PFLOAT:
+                    *str += "        putDouble(" + at + ", " + value + ");\n";
+                    break;
+                    case PENUM:
+                    *str += "        put32(" + at + ", (uint32_t)" + value + ");\n";
+                    break;
+                    case PAST:
+                    *str += "        putRel(" + at + ", writeNode(" + value + "));\n";
+                    break;
+                    case PLIST:
+                    *str += "        putRel(" + at + ", writeList(" + listPtr("node", member.first) + "));\n";
+                    break;
+                }
+                fieldOffset += snapshotFieldSize(typedPart);
+            }
+            *str += "        return offset;\n"
+                    "    }\n";
+        }
+        *str += "    // Magic, root offset and grammar fingerprint\n"
+                "    void writeHeader() {\n"
+                "        alloc(16);\n"
+                "        memcpy(&image[0], " + key + "SnapMagic, 4);\n"
+                "        put64(8, " + key + "GrammarFingerprint);\n"
+                "    }\n"
+                "    // Header, then records. Returns false when the\n"
+                "    // tree is over the 2GB reachable by relative offsets.\n"
+                "    bool write(" + startType() + " root) {\n"
+                "        image.clear();\n"
+                "        stringOffsets.clear();\n"
+                "        writeHeader();\n";
+        *str += (startPart->type == PLIST) ? "        uint32_t rootOffset = writeList(root);\n"
+                                           : "        uint32_t rootOffset = writeNode(root);\n";
+        *str += "        put32(4, rootOffset);\n"
+                "        return image.size() <= 0x7fffffff;\n"
+                "    }\n"
+                "    static bool saveFile(" + startType() + " root, std::string fileName) {\n"
+                "        " + writerName + " writer;\n"
+                "        if (!writer.write(root)) return false;\n"
+                "        FILE *file = fopen(fileName.c_str(), \"wb\");\n"
+                "        if (!file) return false;\n"
+                "        bool ok = fwrite(writer.image.data(), 1, writer.image.size(), file) == writer.image.size();\n"
+                "        return (fclose(file) == 0) && ok;\n"
+                "    }\n"
+                "};\n";
+        // Views
+        *str += "class SnapNode {\n"
+                "public:\n"
+                "    const char *rec;\n"
+                "    SnapNode(const char *rec) : rec(rec) {}\n"
+                "    bool isNull() const { return rec == nullptr; }\n"
+                "    NodeType nodeType() const {\n"
+                "        uint32_t type;\n"
+                "        memcpy(&type, rec, 4);\n"
+                "        return static_cast<NodeType>(type);\n"
+                "    }\n"
+                "    static const char* follow(const char *field) {\n"
+                "        int32_t rel;\n"
+                "        memcpy(&rel, field, 4);\n"
+                "        return (rel == 0) ? nullptr : field + rel;\n"
+                "    }\n"
+                "    static uint32_t get32(const char *field) {\n"
+                "        uint32_t val;\n"
+                "        memcpy(&val, field, 4);\n"
+                "        return val;\n"
+                "    }\n"
+                "    static int64_t get64(const char *field) {\n"
+                "        int64_t val;\n"
+                "        memcpy(&val, field, 8);\n"
+                "        return val;\n"
+                "    }\n"
+                "    static double getDouble(const char *field) {\n"
+                "        double val;\n"
+                "        memcpy(&val, field, 8);\n"
+                "        return val;\n"
+                "    }\n"
+                "};\n";
+        *str += "class SnapString {\n"
+                "public:\n"
+                "    const char *rec;\n"
+                "    SnapString(const char *rec) : rec(rec) {}\n"
+                "    uint32_t size() const { return (rec == nullptr) ? 0 : SnapNode::get32(rec); }\n"
+                "    const char* data() const { return (rec == nullptr) ? \"\" : rec + 4; }\n"
+                "    std::string str() const { return std::string(data(), size()); }\n"
+                "};\n";
+        *str += "class SnapList {\n"
+                "public:\n"
+                "    const char *rec;\n"
+                "    SnapList(const char *rec) : rec(rec) {}\n"
+                "    bool isNull() const { return rec == nullptr; }\n"
+                "    uint32_t size() const { return (rec == nullptr) ? 0 : SnapNode::get32(rec); }\n"
+                "    SnapNode operator[](uint32_t i) const { return SnapNode(SnapNode::follow(rec + 4 + 4 * i)); }\n"
+                "};\n";
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() == 0) continue;
+            string viewName = "Snap" + astClass.first;
+            *str += "class " + viewName + " : public SnapNode {\n"
+                    "public:\n"
+                    "    " + viewName + "(SnapNode node) : SnapNode(node.rec) {}\n";
+            size_t fieldOffset = 4;
+            for (auto const &member : astClass.second->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                string field = "rec + " + std::to_string(fieldOffset);
+                switch (typedPart->type) {
+                    case PSTRING:
+                    case PTOKEN:
+                    *str += "    SnapString " + member.first + "() const { return SnapString(follow(" + field + ")); }\n";
+                    break;
+                    case PINT: {
+                        string intType;
+                        typedPart->generateGrammarType(&intType, langData);
+                        *str += "    " + intType + " " + member.first + "() const { return (" + intType + ")get64(" + field + "); }\n";
+                    }
+                    break;
+                    case PFLOAT:
+                    *str += "    double " + member.first + "() const { return getDouble(" + field + "); }\n";
+                    break;
+                    case PENUM: {
+                        string enumType = static_cast<TypedPartEnum*>(typedPart)->enumKey;
+                        *str += "    " + enumType + " " + member.first + "() const { return static_cast<" + enumType + ">(get32(" + field + ")); }\n";
+                    }
+                    break;
+                    case PAST:
+                    *str += "    SnapNode " + member.first + "() const { return SnapNode(follow(" + field + ")); }\n";
+                    break;
+                    case PLIST:
+                    *str += "    SnapList " + member.first + "() const { return SnapList(follow(" + field + ")); }\n";
+                    break;
+                }
+                fieldOffset += snapshotFieldSize(typedPart);
+            }
+            *str += "};\n";
+        }
+        // File mapping shared by snapshots and the spill store
+        *str += "class MappedImage {\n"
+                "public:\n"
+                "    const char *data;\n"
+                "    size_t size;\n"
+                "    // Set when read into memory rather than mapped\n"
+                "    std::string owned;\n"
+                "    bool isMapped;\n"
+                "    MappedImage() : data(nullptr), size(0), isMapped(false) {}\n"
+                "    MappedImage(const MappedImage&) = delete;\n"
+                "    MappedImage& operator=(const MappedImage&) = delete;\n"
+                "    ~MappedImage() { close(); }\n"
+                "    // First len bytes of file, which may be closed\n"
+                "    // after. File position is left at the end.\n"
+                "    bool map(FILE *file, size_t len) {\n"
+                "        close();\n"
+                "        if (len == 0) return false;\n"
+                "        #ifdef _WIN32\n"
+                "        owned.resize(len);\n"
+                "        rewind(file);\n"
+                "        bool read = fread(&owned[0], 1, len, file) == len;\n"
+                "        fseek(file, 0, SEEK_END);\n"
+                "        if (!read) {\n"
+                "            owned.clear();\n"
+                "            return false;\n"
+                "        }\n"
+                "        data = owned.data();\n"
+                "        #else\n"
+                "        void *mapped = mmap(nullptr, len, PROT_READ, MAP_SHARED, fileno(file), 0);\n"
+                "        if (mapped == MAP_FAILED) return false;\n"
+                "        data = (const char*)mapped;\n"
+                "        isMapped = true;\n"
+                "        #endif\n"
+                "        size = len;\n"
+                "        return true;\n"
+                "    }\n"
+                "    void close() {\n"
+                "        #ifndef _WIN32\n"
+                "        if (isMapped) munmap((void*)data, size);\n"
+                "        #endif\n"
+                "        data = nullptr;\n"
+                "        size = 0;\n"
+                "        isMapped = false;\n"
+                "        owned.clear();\n"
+                "    }\n"
+                "};\n";
+        // Loaded snapshot
+        string snapName = key + "Snapshot";
+        string rootView = (startPart->type == PLIST) ? "SnapList" : "SnapNode";
+        *str += "class " + snapName + " {\n"
+                "public:\n"
+                "    const char *data;\n"
+                "    size_t size;\n"
+                "    MappedImage image;\n"
+                "    " + snapName + "() : data(nullptr), size(0) {}\n"
+                "    " + snapName + "(const " + snapName + "&) = delete;\n"
+                "    " + snapName + "& operator=(const " + snapName + "&) = delete;\n"
+                "    ~" + snapName + "() { close(); }\n"
+                "    bool open(std::string fileName) {\n"
+                "        close();\n"
+                "        FILE *file = fopen(fileName.c_str(), \"rb\");\n"
+                "        if (!file) return false;\n"
+                "        bool mapped = fseek(file, 0, SEEK_END) == 0 && ftell(file) >= 16\n"
+                "            && image.map(file, (size_t)ftell(file));\n"
+                "        fclose(file);\n"
+                "        if (!mapped) return false;\n"
+                "        data = image.data;\n"
+                "        size = image.size;\n"
+                "        if (!valid()) {\n"
+                "            close();\n"
+                "            return false;\n"
+                "        }\n"
+                "        return true;\n"
+                "    }\n"
+                "    // Snapshot already in memory, which must\n"
+                "    // outlive this object\n"
+                "    bool openMemory(const char *image, size_t len) {\n"
+                "        close();\n"
+                "        data = image;\n"
+                "        size = len;\n"
+                "        if (!valid()) {\n"
+                "            data = nullptr;\n"
+                "            size = 0;\n"
+                "            return false;\n"
+                "        }\n"
+                "        return true;\n"
+                "    }\n"
+                "    // Checks header only, records are trusted\n"
+                "    bool valid() const {\n"
+                "        return size >= 16 && memcmp(data, " + key + "SnapMagic, 4) == 0\n"
+                "            && SnapNode::get32(data + 4) < size\n"
+                "            && (uint64_t)SnapNode::get64(data + 8) == " + key + "GrammarFingerprint;\n"
+                "    }\n"
+                "    " + rootView + " root() const {\n"
+                "        uint32_t offset = SnapNode::get32(data + 4);\n"
+                "        return " + rootView + "((offset == 0) ? nullptr : data + offset);\n"
+                "    }\n"
+                "    void close() {\n"
+                "        image.close();\n"
+                "        data = nullptr;\n"
+                "        size = 0;\n"
+                "    }\n"
+                "};\n";
+        if (langData->options.spill) {
+            generateSpillStore(str);
+        }
+        saveToFile(str, "gen/" + key + "Snapshot.hpp");
+    }
+
+    // Spilled items are appended to a temporary file,
+    // each as a snapshot image of its own. After the
+    // parse the file is mapped, and items are paged
+    // in by the system as their views are read.
+    void generateSpillStore(string *str) {
+        string key = langData->langKey;
+        string storeName = key + "SpillStore";
+        *str += "class " + storeName + " : public SpillSink {\n"
+                "public:\n"
+                "    struct Extent {\n"
+                "        uint64_t offset;\n"
+                "        uint64_t size;\n"
+                "    };\n"
+                "    FILE *file;\n"
+                "    uint64_t fileSize;\n"
+                "    // Items by list address and index, size 0 when in\n"
+                "    // memory. Addresses are only valid while the tree\n"
+                "    // holding the lists is alive, and may be reused.\n"
+                "    std::unordered_map<const void*, std::vector<Extent>> items;\n"
+                "    MappedImage image;\n"
+                "    " + key + "SnapshotWriter writer;\n"
+                "    " + storeName + "() : fileSize(0) {\n"
+                "        file = tmpfile();\n"
+                "        if (!file) {\n"
+                "            printf(\"Can't create spill file\\n\");\n"
+                "            exit(1);\n"
+                "        }\n"
+                "    }\n"
+                "    " + storeName + "(const " + storeName + "&) = delete;\n"
+                "    " + storeName + "& operator=(const " + storeName + "&) = delete;\n"
+                "    ~" + storeName + "() {\n"
+                "        unmap();\n"
+                "        fclose(file);\n"
+                "    }\n"
+                "    void spill(AstNode *node, const void *list, size_t index) {\n"
+                "        writer.image.clear();\n"
+                "        writer.stringOffsets.clear();\n"
+                "        writer.writeHeader();\n"
+                "        writer.put32(4, writer.writeNode(node));\n"
+                "        if (writer.image.size() > 0x7fffffff) {\n"
+                "            printf(\"Spilled item over 2GB\\n\");\n"
+                "            exit(1);\n"
+                "        }\n"
+                "        // Keeps the next image aligned\n"
+                "        writer.image.append((8 - writer.image.size() % 8) % 8, '\\0');\n"
+                "        if (fwrite(writer.image.data(), 1, writer.image.size(), file) != writer.image.size()) {\n"
+                "            printf(\"Can't write spill file\\n\");\n"
+                "            exit(1);\n"
+                "        }\n"
+                "        std::vector<Extent> &listItems = items[list];\n"
+                "        if (listItems.size() <= index) listItems.resize(index + 1, Extent{0, 0});\n"
+                "        listItems[index] = Extent{fileSize, writer.image.size()};\n"
+                "        fileSize += writer.image.size();\n"
+                "        destroyTree(node);\n"
+                "    }\n"
+                "    // Maps the file, call when the parse is done\n"
+                "    bool open() {\n"
+                "        unmap();\n"
+                "        if (fflush(file) != 0) return false;\n"
+                "        if (fileSize == 0) return true;\n"
+                "        return image.map(file, fileSize);\n"
+                "    }\n"
+                "    bool isSpilled(const void *list, size_t index) const {\n"
+                "        auto found = items.find(list);\n"
+                "        return found != items.end() && index < found->second.size() && found->second[index].size > 0;\n"
+                "    }\n"
+                "    // View of a spilled item, valid while the store\n"
+                "    // is open. Null when the item is in memory. Pass\n"
+                "    // the list of the parsed tree, not a copy of it.\n"
+                "    SnapNode item(const void *list, size_t index) const {\n"
+                "        if (image.data == nullptr || !isSpilled(list, index)) return SnapNode(nullptr);\n"
+                "        const char *item = image.data + items.find(list)->second[index].offset;\n"
+                "        uint32_t offset = SnapNode::get32(item + 4);\n"
+                "        return SnapNode((offset == 0) ? nullptr : item + offset);\n"
+                "    }\n"
+                "    void unmap() {\n"
+                "        image.close();\n"
+                "    }\n"
+                "};\n";
+    }
+
     void generateTransformer(){}
 
     /**
@@ -527,12 +3862,147 @@ public:
         return static_cast<SourceNode*>(result);
     }
 
+    // Columnar tables built from a tree. Each constructed
+    // class gets a table with a column per member, ast
+    // members become NodeIds and lists become ranges in
+    // a shared children column.
+    void generateColumns() {
+        string *str = new string;
+        string key = langData->langKey;
+        string className = key + "Columns";
+        TypedPart *startPart = langData->startAction->startPart;
+        // Tag bits hold nodeType + 1, so zero is null
+        int tagBits = 1;
+        while ((size_t(1) << tagBits) < langData->astClasses.size() + 1) ++tagBits;
+        string indexBits = std::to_string(32 - tagBits);
+        vector<AstClass*> classes;
+        for (auto const &astClass : langData->astClasses) {
+            if (astClass.second->constructors.size() > 0) classes.push_back(astClass.second);
+        }
+        *str += "#pragma once\n";
+        *str += "#include \"" + key + ".hpp\"\n";
+        *str += "#include <string>\n"
+                "#include <vector>\n"
+                "#include <stdint.h>\n"
+                "#include <stdio.h>\n"
+                "#include <stdlib.h>\n";
+        *str += "// Node type in the high bits, table index in the low bits\n"
+                "typedef uint32_t NodeId;\n"
+                "static const int NodeIdIndexBits = " + indexBits + ";\n"
+                "inline NodeId makeNodeId(NodeType nodeType, size_t index) {\n"
+                "    if (index >= (size_t(1) << NodeIdIndexBits)) {\n"
+                "        printf(\"Too many nodes for NodeId\\n\");\n"
+                "        exit(1);\n"
+                "    }\n"
+                "    return ((uint32_t)nodeType + 1) << NodeIdIndexBits | (uint32_t)index;\n"
+                "}\n"
+                "inline NodeType nodeIdType(NodeId id) {\n"
+                "    return (NodeType)((id >> NodeIdIndexBits) - 1);\n"
+                "}\n"
+                "inline uint32_t nodeIdIndex(NodeId id) {\n"
+                "    return id & ((uint32_t(1) << NodeIdIndexBits) - 1);\n"
+                "}\n"
+                "// Elements of a list in the children column\n"
+                "struct ChildRange {\n"
+                "    uint32_t begin;\n"
+                "    uint32_t count;\n"
+                "};\n";
+        *str += "class " + className + " {\n"
+                "public:\n";
+        for (AstClass *cls : classes) {
+            *str += "    struct " + cls->identifier + "Table {\n"
+                    "        size_t count = 0;\n";
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                string columnType;
+                if (typedPart->type == PAST) {
+                    columnType = "NodeId";
+                } else if (typedPart->type == PLIST) {
+                    columnType = "ChildRange";
+                } else {
+                    typedPart->generateGrammarType(&columnType, langData);
+                }
+                *str += "        std::vector<" + columnType + "> " + member.first + ";\n";
+            }
+            *str += "    };\n";
+        }
+        for (AstClass *cls : classes) {
+            string tableKey = cls->identifier;
+            tableKey[0] = std::tolower(tableKey[0]);
+            *str += "    " + cls->identifier + "Table " + tableKey + "Table;\n";
+        }
+        *str += "    std::vector<NodeId> children;\n";
+        if (startPart->type == PLIST) {
+            *str += "    ChildRange root = ChildRange{0, 0};\n";
+        } else {
+            *str += "    NodeId root = 0;\n";
+        }
+        *str += "    void build(" + startType() + " node) {\n";
+        *str += (startPart->type == PLIST) ? "        root = addList(node);\n" : "        root = add(node);\n";
+        *str += "    }\n";
+        *str += "    NodeId add(AstNode *node) {\n"
+                "        if (node == nullptr) return 0;\n"
+                "        switch (node->nodeType) {\n";
+        for (AstClass *cls : classes) {
+            *str += "            case " + cls->identifier + "Node: ";
+            *str += "return add" + cls->identifier + "(static_cast<" + cls->identifier + "*>(node));\n";
+        }
+        *str += "            default: return 0;\n"
+                "        }\n"
+                "    }\n";
+        *str += "    // Elements are added before the range is\n"
+                "    // reserved, so nested lists don't interleave\n"
+                "    template<typename L>\n"
+                "    ChildRange addList(L *list) {\n"
+                "        if (list == nullptr) return ChildRange{0, 0};\n"
+                "        std::vector<NodeId> ids;\n"
+                "        ids.reserve(list->size());\n"
+                "        for (AstNode *node : *list) ids.push_back(add(node));\n"
+                "        ChildRange range = ChildRange{(uint32_t)children.size(), (uint32_t)ids.size()};\n"
+                "        children.insert(children.end(), ids.begin(), ids.end());\n"
+                "        return range;\n"
+                "    }\n";
+        for (AstClass *cls : classes) {
+            string tableKey = cls->identifier;
+            tableKey[0] = std::tolower(tableKey[0]);
+            tableKey += "Table";
+            *str += "    NodeId add" + cls->identifier + "(" + cls->identifier + " *node) {\n";
+            // Children first, their adds may grow other tables
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST) {
+                    *str += "        NodeId " + member.first + " = add(node->" + member.first + ");\n";
+                } else if (typedPart->type == PLIST) {
+                    *str += "        ChildRange " + member.first + " = addList(" + listPtr("node", member.first) + ");\n";
+                }
+            }
+            for (auto const &member : cls->members) {
+                TypedPart *typedPart = member.second->typedPart;
+                if (typedPart->type == PAST || typedPart->type == PLIST) {
+                    *str += "        " + tableKey + "." + member.first + ".push_back(" + member.first + ");\n";
+                } else {
+                    *str += "        " + tableKey + "." + member.first + ".push_back(node->" + member.first + ");\n";
+                }
+            }
+            *str += "        return makeNodeId(" + cls->identifier + "Node, " + tableKey + ".count++);\n"
+                    "    }\n";
+        }
+        *str += "    const NodeId* childrenBegin(ChildRange range) const {\n"
+                "        return children.data() + range.begin;\n"
+                "    }\n"
+                "    const NodeId* childrenEnd(ChildRange range) const {\n"
+                "        return children.data() + range.begin + range.count;\n"
+                "    }\n"
+                "};\n";
+        saveToFile(str, "gen/" + key + "Columns.hpp");
+    }
+
     /**
      * Runs the pipeline to generate files
      */
-    static void genFiles(string folder, string langKey) {
+    static void genFiles(string folder, string langKey, GenOptions options = GenOptions()) {
         auto result = parseDescr(folder + "/" + langKey + ".lang");
-        auto langData = new LData(langKey);
+        auto langData = new LData(langKey, options);
         auto keysVisit = new RegisterKeysVisitor(langData);
         auto listVisit = new RegisterListKeysVisitor(langData);
         auto builtInVisit = new AddBuiltInTokens(langData);
@@ -553,6 +4023,15 @@ public:
         sourceGen->generateVisitor();
         sourceGen->generateToSource(result);
         sourceGen->generateTransformer();
+        if (options.hasSerializer()) {
+            sourceGen->generateSerializer();
+        }
+        if (options.hasSnapshot()) {
+            sourceGen->generateSnapshot();
+        }
+        if (options.columns) {
+            sourceGen->generateColumns();
+        }
         sourceGen->runFlexBison();
     }
 };
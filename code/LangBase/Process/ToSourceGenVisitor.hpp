@@ -26,11 +26,54 @@ class ToSourceCase {
 public:
     LData *langData;
     string code;
+    // Same steps as code, summing up
+    // the length of the output
+    string measureCode;
     string serialized;
     string grammarKey;
     bool isClassKey;
     ToSourceCase(LData *langData, string grammarKey, bool isClassKey)
         : langData(langData), grammarKey(grammarKey), isClassKey(isClassKey) {}
+    // Output of literal source text
+    void addLiteral(string literal) {
+        code += "    " + literalOutput(langData, literal) + "\n";
+        measureCode += "    len += " + std::to_string(literal.size()) + ";\n";
+    }
+    // Output of expression giving a std::string,
+    // with expression giving its length
+    void addString(string expr, string lengthExpr) {
+        code += "    " + stringOutput(langData, expr) + "\n";
+        measureCode += "    len += " + lengthExpr + ";\n";
+    }
+    // Call to visit, astKey or listKey method
+    void addCall(string method, string arg) {
+        code += "    " + method + "(" + arg + ");\n";
+        measureCode += "    len += measure_" + method + "(" + arg + ");\n";
+    }
+    // Statements writing to the string or through out()
+    // depending on options. Literal lengths are known
+    // here, so out() doesn't need strlen. Lossless mode
+    // first writes the trivia of the source token.
+    static string literalOutput(LData *langData, string literal) {
+        if (langData->options.hasToSourceOut()) {
+            return "out(\"" + literal + "\", " + std::to_string(literal.size()) + ");";
+        }
+        if (langData->options.lossless) {
+            // WS token
+            if (literal == " ") return "spaceTrivia();";
+            return "tokenTrivia(\"" + literal + "\", " + std::to_string(literal.size()) + "); str += \"" + literal + "\";";
+        }
+        return "str += \"" + literal + "\";";
+    }
+    static string stringOutput(LData *langData, string expr) {
+        if (langData->options.hasToSourceOut()) {
+            return "out(" + expr + ");";
+        }
+        if (langData->options.lossless) {
+            return "tokenTrivia(nullptr, 0); str += " + expr + ";";
+        }
+        return "str += " + expr + ";";
+    }
 };
 
 /**
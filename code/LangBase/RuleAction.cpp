@@ -1,4 +1,5 @@
 #include "RuleAction.hpp"
+#include "LangData.hpp"
 
 namespace LangBase {
 
@@ -8,7 +9,45 @@ void RuleAction::generateGrammar(string *str, LData *langData) {
     *str += ";";
 }
 
+// Node event with an arg for each member in key
+// order, zero for members the rule doesn't give
+void AstConstructionAction::generateLazyVal(string *str, LData *langData) {
+    *str += "lazyTree->addNode(" + astClass + "Node, ";
+    if (firstNum > 0 && firstNum <= lastNum) {
+        *str += "@" + std::to_string(firstNum) + ", @" + std::to_string(lastNum);
+    } else {
+        *str += "@$, @$";
+    }
+    *str += ", {";
+    bool isFirst = true;
+    for (auto const &member : langData->astClasses[astClass]->members) {
+        if (!isFirst) *str += ", ";
+        isFirst = false;
+        bool found = false;
+        for (RuleArg &arg : args) {
+            if (arg.typedPart->getMemberKey() == member.first) {
+                arg.typedPart->generateGrammarVal(str, arg.num, langData);
+                found = true;
+                break;
+            }
+        }
+        if (!found) *str += "0";
+    }
+    *str += "})";
+}
+
 void AstConstructionAction::generateGrammarVal(string *str, LData *langData) {
+    if (langData->options.lazyNodes) {
+        generateLazyVal(str, langData);
+        return;
+    }
+    // Optional features hook into new
+    // nodes through finishNode
+    bool finish = langData->options.hasFinishNode();
+    if (finish) *str += "finishNode(";
+    // Location is set before finishNode
+    bool locations = langData->options.hasLocations();
+    if (locations) *str += "setLocation(";
     *str += "new " + astClass + "(";
     bool isFirst = true;
     for (RuleArg &arg : args) {
@@ -17,6 +56,15 @@ void AstConstructionAction::generateGrammarVal(string *str, LData *langData) {
         isFirst = false;
     }
     *str += ")";
+    if (locations) {
+        if (firstNum > 0 && firstNum <= lastNum) {
+            *str += ", @" + std::to_string(firstNum) + ", @" + std::to_string(lastNum) + ")";
+        } else {
+            // Empty rule
+            *str += ", @$, @$)";
+        }
+    }
+    if (finish) *str += ")";
 }
 
 void RefAction::generateGrammarVal(string *str, LData *langData) {
@@ -28,23 +76,43 @@ void EnumValueAction::generateGrammarVal(string *str, LData *langData) {
 }
 
 void ListInitAction::generateGrammarVal(string *str, LData *langData) {
+    if (langData->options.lazyNodes) {
+        *str += "lazyTree->addEmptyList(@$)";
+        return;
+    }
+    if (langData->options.inlineListSlots > 0) {
+        *str += "NodeList<";
+        type->generateGrammarType(str, langData);
+        *str += ">::acquire()";
+        return;
+    }
     *str += "new std::vector<";
     type->generateGrammarType(str, langData);
     *str += ">";
 }
 
 void ListPushAction::generateGrammar(string *str, LData *langData) {
+    if (langData->options.lazyNodes) {
+        // Item event linking to the previous
+        *str += "$$ = lazyTree->addListItem($" + std::to_string(listNum) + ", ";
+        innerAction->generateGrammarVal(str, langData);
+        *str += ", @$);";
+        return;
+    }
     // Reinterpret as list type to "vec" variable
-    *str += "std::vector<";
+    string listClass = (langData->options.inlineListSlots > 0) ? "NodeList<" : "std::vector<";
+    *str += listClass;
     listType->generateGrammarType(str, langData);
-    *str += ">* vec = reinterpret_cast<std::vector<";
+    *str += ">* vec = reinterpret_cast<" + listClass;
     listType->generateGrammarType(str, langData);
     *str += ">*>($" + std::to_string(listNum) + ");";
-    // Push back element
-    *str += "vec->push_back(";
+    // Push back element, or a null in
+    // its place when it is spilled
+    bool spill = langData->isSpillList(listKey);
+    *str += spill ? "vec->push_back(spillItem(" : "vec->push_back(";
     // Todo, split up if code needs to be run before
     innerAction->generateGrammarVal(str, langData);
-    *str += ");$$ = ";
+    *str += spill ? ", vec));$$ = " : ");$$ = ";
     generateGrammarVal(str, langData);
     *str += ";";
 }
@@ -53,6 +121,10 @@ void ListPushAction::generateGrammarVal(string *str, LData *langData) {
 }
 
 void StartAction::generateGrammar(string *str, LData *langData) {
+    if (langData->options.lazyNodes) {
+        *str += "lazyTree->root = $1;$$ = $1;";
+        return;
+    }
     *str += "result = ";
     generateGrammarVal(str, langData);
     *str += ";$$ = result;";
@@ -49,12 +49,17 @@ public:
     vector<RuleArg> args;
     string serialized;
     TypedPart *typed;
+    // Symbol nums spanned by the node, which can
+    // be a part of the rule in list rules
+    int firstNum = 0;
+    int lastNum = 0;
     AstConstructionAction(string astClass) : RuleAction(RAAstConstruction), astClass(astClass)  {}
     AstConstructionAction(string astClass, vector<RuleArg> args)
         : RuleAction(RAAstConstruction), astClass(astClass), args(args) {}
     AstConstructionAction(string astClass, vector<RuleArg> args, string serialized)
         : RuleAction(RAAstConstruction), astClass(astClass), args(args), serialized(serialized) {}
     void generateGrammarVal(string *str, LData *langData);
+    void generateLazyVal(string *str, LData *langData);
 };
 
 /**
@@ -99,6 +104,8 @@ public:
     RuleAction *innerAction;
     TypedPart *type;
     TypedPart *listType;
+    // Grammar key of the list
+    string listKey;
     ListPushAction(int listNum, int elemNum, TypedPart *type, TypedPart *listType)
         : RuleAction(RAListPush), listNum(listNum), elemNum(elemNum), type(type), listType(listType) {}
     ListPushAction(int listNum, RuleAction *innerAction, TypedPart *type, TypedPart *listType)
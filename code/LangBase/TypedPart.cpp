@@ -38,11 +38,23 @@ string TypedPartToken::getCleanedVal(LData *langData) {
     return cleaned;
 }
 void TypedPartToken::addToVisitor(ToSourceCase *visitor) {
-    visitor->code += "    str += \"" + getCleanedVal(visitor->langData) + "\";\n";
+    visitor->addLiteral(getCleanedVal(visitor->langData));
 }
 
 void TypedPartPrim::generateGrammarVal(string *str, int num, LData *langData) {
-    *str += "$" + std::to_string(num);
+    if (langData->options.lazyNodes) {
+        // Stored as event args
+        switch (type) {
+            case PSTRING: *str += "lazyTree->stringArg($"; break;
+            case PFLOAT: *str += "LazyTree::floatArg($"; break;
+            default: *str += "LazyTree::valueArg($"; break;
+        }
+        *str += std::to_string(num) + ")";
+    } else if (type == PSTRING && langData->options.moveStrings) {
+        *str += "takeString($" + std::to_string(num) + ")";
+    } else {
+        *str += "$" + std::to_string(num);
+    }
 }
 void TypedPartPrim::generateGrammarType(string *str, LData *langData) {
     switch (type) {
@@ -50,7 +62,7 @@ void TypedPartPrim::generateGrammarType(string *str, LData *langData) {
         *str += "std::string";
         break;
         case PINT:
-        *str += "int";
+        *str += intType;
         break;
         case PFLOAT:
         *str += "double";
@@ -62,13 +74,13 @@ void TypedPartPrim::generateGrammarType(string *str, LData *langData) {
 void TypedPartPrim::addToVisitor(ToSourceCase *visitor) {
     switch (type) {
         case PSTRING:
-        visitor->code += "    str += node->" + getMemberKey() + ";\n";
+        visitor->addString("node->" + getMemberKey(), "node->" + getMemberKey() + ".size()");
         break;
         case PINT:
-        visitor->code += "    str += std::to_string(node->" + getMemberKey() + ");\n";
+        visitor->addString("std::to_string(node->" + getMemberKey() + ")", "intLength(node->" + getMemberKey() + ")");
         break;
         case PFLOAT:
-        visitor->code += "    str += std::to_string(node->" + getMemberKey() + ");\n";
+        visitor->addString("std::to_string(node->" + getMemberKey() + ")", "std::to_string(node->" + getMemberKey() + ").size()");
         break;
         default: {
             printf("Unrecognized prim type in addToVisitor\n");
@@ -78,16 +90,26 @@ void TypedPartPrim::addToVisitor(ToSourceCase *visitor) {
 }
 
 void TypedPartEnum::generateGrammarVal(string *str, int num, LData *langData) {
+    if (langData->options.lazyNodes) {
+        *str += "LazyTree::valueArg($" + std::to_string(num) + ")";
+        return;
+    }
     *str += "static_cast<" + enumKey + ">($" + std::to_string(num) + ")";
 }
 void TypedPartEnum::generateGrammarType(string *str, LData *langData) {
     *str += enumKey;
 }
 void TypedPartEnum::addToVisitor(ToSourceCase *visitor) {
-    visitor->code += "    str += enum" + identifier + "ToString(node->" + getMemberKey() + ");\n";
+    visitor->addString("enum" + identifier + "ToString(node->" + getMemberKey() + ")",
+                       "enum" + identifier + "Length(node->" + getMemberKey() + ")");
 }
 
 void TypedPartAst::generateGrammarVal(string *str, int num, LData *langData) {
+    // Lazy nodes pass event indexes
+    if (langData->options.lazyNodes) {
+        *str += "$" + std::to_string(num);
+        return;
+    }
     *str += "reinterpret_cast<" + astClass + "*>($" + std::to_string(num) + ")";
 }
 void TypedPartAst::generateGrammarType(string *str, LData *langData) {
@@ -95,33 +117,42 @@ void TypedPartAst::generateGrammarType(string *str, LData *langData) {
 }
 void TypedPartAst::addToVisitor(ToSourceCase *visitor) {
     if (visitor->isClassKey) {
-        visitor->code += "    visit" + astClass + "(node->" + getMemberKey() + ");\n";
+        visitor->addCall("visit" + astClass, "node->" + getMemberKey());
     } else {
-        visitor->code += "    astKey_" + alias + "(node->" + getMemberKey() + ");\n";
+        visitor->addCall("astKey_" + alias, "node->" + getMemberKey());
     }
 }
 
 void TypedPartList::generateGrammarVal(string *str, int num, LData *langData) {
+    if (langData->options.lazyNodes) {
+        *str += "$" + std::to_string(num);
+        return;
+    }
     *str += "reinterpret_cast<";
     generateGrammarType(str, langData);
     *str += ">($" + std::to_string(num) + ")";
 }
 void TypedPartList::generateGrammarType(string *str, LData *langData) {
-    *str += "std::vector<";
+    // Inline lists are filled by the parser in place
+    *str += (langData->options.inlineListSlots > 0) ? "NodeList<" : "std::vector<";
     type->generateGrammarType(str, langData);
     *str += ">*";
 }
 void TypedPartList::addToVisitor(ToSourceCase *visitor) {
-    visitor->code += "    listKey_" + identifier + "(node->" + getMemberKey() + ");\n";
+    if (visitor->langData->options.inlineListSlots > 0) {
+        visitor->addCall("listKey_" + identifier, "&node->" + getMemberKey());
+        return;
+    }
+    visitor->addCall("listKey_" + identifier, "node->" + getMemberKey());
     return;
     if (type->type == PAST) {
         TypedPartAst *astType = static_cast<TypedPartAst*>(type);
-        visitor->code += "for (";
-        type->generateGrammarType(&visitor->code, visitor->langData);
         string memberKey = getMemberKey();
-        visitor->code += " child : *node->" + memberKey + ") {\n";
+        visitor->code += "for (size_t i = 0; i < node->" + memberKey + "->size(); ++i) {\n";
+        type->generateGrammarType(&visitor->code, visitor->langData);
+        visitor->code += " child = (*node->" + memberKey + ")[i];\n";
         if (sepBetween) {
-            visitor->code += "if (child != node->" + memberKey + "->front()) {\n";
+            visitor->code += "if (i > 0) {\n";
             sep->addToVisitor(visitor);
             visitor->code += "}\n";
         }
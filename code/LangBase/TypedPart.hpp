@@ -82,8 +82,10 @@ public:
 // Prim token part
 class TypedPartPrim : public TypedPart {
 public:
-    TypedPartPrim(PartType type, string identifier)
-        : TypedPart(type, identifier) {}
+    // C++ type of PINT parts
+    string intType;
+    TypedPartPrim(PartType type, string identifier, string intType = "int")
+        : TypedPart(type, identifier), intType(intType) {}
     void generateGrammarVal(string *str, int num, LData *langData);
     void generateGrammarType(string *str, LData *langData);
     void addToVisitor(ToSourceCase *visitor);
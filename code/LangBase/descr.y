@@ -23,6 +23,16 @@ inline T* re(void *node) {
 
 extern int yylineno;
 
+// Token types without keywords in the lexer
+int tokenTypeFromName(const char *name) {
+	std::string typeName = name;
+	if (typeName == "int64") return TINT64;
+	if (typeName == "uint64") return TUINT64;
+	if (typeName == "double") return TFLOAT;
+	printf("Unknown token type %s on line %d\n", name, yylineno);
+	exit(1);
+}
+
 %}
 %union {
 	int ival;
@@ -75,6 +85,7 @@ start: START IDENTIFIER { $$ = new StartNode($2); }
 tokenType: TOKEN_STRING { $$ = TSTRING; }
         | TOKEN_INT { $$ = TINT; }
         | TOKEN_FLOAT { $$ = TFLOAT; }
+        | IDENTIFIER { $$ = tokenTypeFromName($1); }
         ;
 
 token_decl: TOKEN IDENTIFIER STRING {
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
+/* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -36,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -43,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.3"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -55,61 +57,16 @@
 /* Pure parsers.  */
 #define YYPURE 0
 
-/* Using locations.  */
-#define YYLSP_NEEDED 0
-
-
-
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     IDENTIFIER = 258,
-     TOKEN = 259,
-     ENUM = 260,
-     AST = 261,
-     LIST = 262,
-     LEFT_BRACE = 263,
-     RIGHT_BRACE = 264,
-     LEFT_PAREN = 265,
-     RIGHT_PAREN = 266,
-     LBRACKET = 267,
-     RBRACKET = 268,
-     COMMA = 269,
-     COLON = 270,
-     START = 271,
-     STRING = 272,
-     TOKEN_STRING = 273,
-     TOKEN_INT = 274,
-     TOKEN_FLOAT = 275
-   };
-#endif
-/* Tokens.  */
-#define IDENTIFIER 258
-#define TOKEN 259
-#define ENUM 260
-#define AST 261
-#define LIST 262
-#define LEFT_BRACE 263
-#define RIGHT_BRACE 264
-#define LEFT_PAREN 265
-#define RIGHT_PAREN 266
-#define LBRACKET 267
-#define RBRACKET 268
-#define COMMA 269
-#define COLON 270
-#define START 271
-#define STRING 272
-#define TOKEN_STRING 273
-#define TOKEN_INT 274
-#define TOKEN_FLOAT 275
-
-
-
-
-/* Copy the first part of user declarations.  */
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
 #line 1 "../code/LangBase/descr.y"
 
 #include <stdio.h>
@@ -136,82 +93,175 @@ inline T* re(void *node) {
 
 extern int yylineno;
 
+// Token types without keywords in the lexer
+int tokenTypeFromName(const char *name) {
+	std::string typeName = name;
+	if (typeName == "int64") return TINT64;
+	if (typeName == "uint64") return TUINT64;
+	if (typeName == "double") return TFLOAT;
+	printf("Unknown token type %s on line %d\n", name, yylineno);
+	exit(1);
+}
 
 
-/* Enabling traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
+#line 108 "../code/LangBase/gen/descr.tab.cpp"
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
-#endif
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 27 "../code/LangBase/descr.y"
+#include "descr.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-	int ival;
-	double fval;
-	char *sval;
-	void *ast;
-	void *vector;
-	int enm;
-}
-/* Line 193 of yacc.c.  */
-#line 172 "../code/LangBase/gen/descr.tab.cpp"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
-# define YYSTYPE_IS_TRIVIAL 1
-#endif
-
-
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IDENTIFIER = 3,                 /* IDENTIFIER  */
+  YYSYMBOL_TOKEN = 4,                      /* TOKEN  */
+  YYSYMBOL_ENUM = 5,                       /* ENUM  */
+  YYSYMBOL_AST = 6,                        /* AST  */
+  YYSYMBOL_LIST = 7,                       /* LIST  */
+  YYSYMBOL_LEFT_BRACE = 8,                 /* LEFT_BRACE  */
+  YYSYMBOL_RIGHT_BRACE = 9,                /* RIGHT_BRACE  */
+  YYSYMBOL_LEFT_PAREN = 10,                /* LEFT_PAREN  */
+  YYSYMBOL_RIGHT_PAREN = 11,               /* RIGHT_PAREN  */
+  YYSYMBOL_LBRACKET = 12,                  /* LBRACKET  */
+  YYSYMBOL_RBRACKET = 13,                  /* RBRACKET  */
+  YYSYMBOL_COMMA = 14,                     /* COMMA  */
+  YYSYMBOL_COLON = 15,                     /* COLON  */
+  YYSYMBOL_START = 16,                     /* START  */
+  YYSYMBOL_STRING = 17,                    /* STRING  */
+  YYSYMBOL_TOKEN_STRING = 18,              /* TOKEN_STRING  */
+  YYSYMBOL_TOKEN_INT = 19,                 /* TOKEN_INT  */
+  YYSYMBOL_TOKEN_FLOAT = 20,               /* TOKEN_FLOAT  */
+  YYSYMBOL_YYACCEPT = 21,                  /* $accept  */
+  YYSYMBOL_source = 22,                    /* source  */
+  YYSYMBOL_nodes = 23,                     /* nodes  */
+  YYSYMBOL_start = 24,                     /* start  */
+  YYSYMBOL_tokenType = 25,                 /* tokenType  */
+  YYSYMBOL_token_decl = 26,                /* token_decl  */
+  YYSYMBOL_enum_def = 27,                  /* enum_def  */
+  YYSYMBOL_enum_decls = 28,                /* enum_decls  */
+  YYSYMBOL_enum_decl = 29,                 /* enum_decl  */
+  YYSYMBOL_type_decl = 30,                 /* type_decl  */
+  YYSYMBOL_ast = 31,                       /* ast  */
+  YYSYMBOL_ast_defs = 32,                  /* ast_defs  */
+  YYSYMBOL_ast_def = 33,                   /* ast_def  */
+  YYSYMBOL_ast_parts = 34,                 /* ast_parts  */
+  YYSYMBOL_ast_part = 35,                  /* ast_part  */
+  YYSYMBOL_list = 36,                      /* list  */
+  YYSYMBOL_list_defs = 37,                 /* list_defs  */
+  YYSYMBOL_list_def = 38                   /* list_def  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Copy the second part of user declarations.  */
 
 
-/* Line 216 of yacc.c.  */
-#line 185 "../code/LangBase/gen/descr.tab.cpp"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -219,55 +269,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int i)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (i)
-    int i;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return i;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
 #endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -284,11 +385,11 @@ YYID (i)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -296,8 +397,8 @@ YYID (i)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -311,88 +412,89 @@ YYID (i)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss;
-  YYSTYPE yyvs;
-  };
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack)					\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack, Stack, yysize);				\
-	Stack = &yyptr->Stack;						\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
@@ -403,19 +505,24 @@ union yyalloc
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  18
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  42
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  74
+#define YYNRULES  44
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  75
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   275
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -448,268 +555,192 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     5,     6,     9,    12,    15,    18,    21,
-      24,    26,    28,    30,    34,    40,    46,    47,    50,    54,
-      57,    59,    63,    69,    75,    76,    79,    83,    85,    90,
-      94,    95,    98,   100,   104,   109,   115,   116,   119,   123,
-     125,   130,   136
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      22,     0,    -1,    23,    -1,    -1,    23,    26,    -1,    23,
-      27,    -1,    23,    31,    -1,    23,    36,    -1,    23,    24,
-      -1,    16,     3,    -1,    18,    -1,    19,    -1,    20,    -1,
-       4,     3,    17,    -1,     4,     3,    15,    25,    17,    -1,
-       5,    30,     8,    28,     9,    -1,    -1,    28,    29,    -1,
-      28,    14,    29,    -1,     3,    17,    -1,     3,    -1,     3,
-      15,     3,    -1,     6,    30,    10,    34,    11,    -1,     6,
-      30,     8,    32,     9,    -1,    -1,    32,    33,    -1,    32,
-      14,    33,    -1,     3,    -1,     3,    10,    34,    11,    -1,
-      10,    34,    11,    -1,    -1,    34,    35,    -1,     3,    -1,
-       3,    15,     3,    -1,     7,    30,     3,     3,    -1,     7,
-      30,     8,    37,     9,    -1,    -1,    37,    38,    -1,    37,
-      14,    38,    -1,     3,    -1,     3,    10,    34,    11,    -1,
-       3,     3,    10,    34,    11,    -1,     3,    10,    34,    11,
-       3,    -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    60,    60,    63,    66,    67,    68,    69,    70,    72,
-      75,    76,    77,    80,    83,    87,    90,    93,    94,    96,
-      97,    98,   100,   103,   107,   110,   111,   113,   114,   115,
-     117,   120,   123,   124,   127,   128,   133,   136,   137,   139,
-     140,   143,   146
+       0,    70,    70,    73,    76,    77,    78,    79,    80,    82,
+      85,    86,    87,    88,    91,    94,    98,   101,   104,   105,
+     107,   108,   109,   111,   114,   118,   121,   122,   124,   125,
+     126,   128,   131,   134,   135,   138,   139,   144,   147,   148,
+     150,   151,   152,   155,   158
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "IDENTIFIER", "TOKEN", "ENUM", "AST",
-  "LIST", "LEFT_BRACE", "RIGHT_BRACE", "LEFT_PAREN", "RIGHT_PAREN",
-  "LBRACKET", "RBRACKET", "COMMA", "COLON", "START", "STRING",
-  "TOKEN_STRING", "TOKEN_INT", "TOKEN_FLOAT", "$accept", "source", "nodes",
-  "start", "tokenType", "token_decl", "enum_def", "enum_decls",
-  "enum_decl", "type_decl", "ast", "ast_defs", "ast_def", "ast_parts",
-  "ast_part", "list", "list_defs", "list_def", 0
+  "\"end of file\"", "error", "\"invalid token\"", "IDENTIFIER", "TOKEN",
+  "ENUM", "AST", "LIST", "LEFT_BRACE", "RIGHT_BRACE", "LEFT_PAREN",
+  "RIGHT_PAREN", "LBRACKET", "RBRACKET", "COMMA", "COLON", "START",
+  "STRING", "TOKEN_STRING", "TOKEN_INT", "TOKEN_FLOAT", "$accept",
+  "source", "nodes", "start", "tokenType", "token_decl", "enum_def",
+  "enum_decls", "enum_decl", "type_decl", "ast", "ast_defs", "ast_def",
+  "ast_parts", "ast_part", "list", "list_defs", "list_def", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    21,    22,    23,    23,    23,    23,    23,    23,    24,
-      25,    25,    25,    26,    26,    27,    28,    28,    28,    29,
-      30,    30,    31,    31,    32,    32,    32,    33,    33,    33,
-      34,    34,    35,    35,    36,    36,    37,    37,    37,    38,
-      38,    38,    38
-};
+#define YYPACT_NINF (-47)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int8 yypact[] =
 {
-       0,     2,     1,     0,     2,     2,     2,     2,     2,     2,
-       1,     1,     1,     3,     5,     5,     0,     2,     3,     2,
-       1,     3,     5,     5,     0,     2,     3,     1,     4,     3,
-       0,     2,     1,     3,     4,     5,     0,     2,     3,     1,
-       4,     5,     5
+     -47,     6,     9,   -47,     5,    23,    23,    23,    37,   -47,
+     -47,   -47,   -47,   -47,   -10,    32,    44,    38,    34,   -47,
+       0,   -47,    40,   -47,   -47,   -47,    48,   -47,   -47,   -47,
+     -47,   -47,    36,   -47,    20,    18,    -2,   -47,    21,   -47,
+      39,   -47,    51,   -47,    45,   -47,   -47,     1,   -47,    42,
+     -47,   -47,    35,   -47,    55,   -47,   -47,   -47,   -47,    -1,
+     -47,    56,    50,   -47,   -47,    28,   -47,   -47,   -47,    30,
+     -47,    33,    58,   -47,   -47
 };
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+static const yytype_int8 yydefact[] =
 {
        3,     0,     2,     1,     0,     0,     0,     0,     0,     8,
-       4,     5,     6,     7,     0,    20,     0,     0,     0,     9,
-       0,    13,     0,    16,    24,    30,     0,    36,    10,    11,
-      12,     0,    21,     0,     0,     0,    34,     0,    14,     0,
-      15,     0,    17,    27,    23,    30,     0,    25,    32,    22,
-      31,    39,    35,     0,    37,    19,    18,    30,     0,    26,
-       0,     0,    30,    38,     0,    29,    33,    30,     0,    28,
-       0,    40,    41,    42
+       4,     5,     6,     7,     0,    21,     0,     0,     0,     9,
+       0,    14,     0,    17,    25,    31,     0,    37,    13,    10,
+      11,    12,     0,    22,     0,     0,     0,    35,     0,    15,
+       0,    16,     0,    18,    28,    24,    31,     0,    26,    33,
+      23,    32,    40,    36,     0,    38,    20,    19,    31,     0,
+      27,     0,    41,    31,    39,     0,    30,    34,    31,     0,
+      29,     0,    42,    43,    44
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -47,   -47,   -47,   -47,   -47,   -47,   -47,   -47,    22,    43,
+     -47,   -47,    15,   -46,   -47,   -47,   -47,    11
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     1,     2,     9,    31,    10,    11,    33,    42,    16,
-      12,    34,    47,    35,    50,    13,    37,    54
+       0,     1,     2,     9,    32,    10,    11,    34,    43,    16,
+      12,    35,    48,    36,    51,    13,    38,    55
 };
 
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -46
-static const yytype_int8 yypact[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
 {
-     -46,     6,    -3,   -46,     7,    18,    18,    18,    39,   -46,
-     -46,   -46,   -46,   -46,    -8,    34,    42,    30,    33,   -46,
-      25,   -46,    45,   -46,   -46,   -46,    48,   -46,   -46,   -46,
-     -46,    35,   -46,     2,     5,    17,   -46,    15,   -46,    36,
-     -46,    51,   -46,    46,   -46,   -46,    27,   -46,    43,   -46,
-     -46,    29,   -46,    52,   -46,   -46,   -46,   -46,    20,   -46,
-      54,    49,   -46,   -46,    22,   -46,   -46,   -46,    23,   -46,
-      24,    57,   -46,   -46
+      59,    49,    49,    28,    44,    20,     3,    21,    14,    50,
+      66,    46,    65,     4,     5,     6,     7,    69,    29,    30,
+      31,    44,    71,    40,    52,     8,    15,    45,    46,    41,
+      53,    49,    47,    49,    42,    54,    49,    26,    62,    70,
+      19,    72,    27,    33,    73,    63,    24,    22,    25,    17,
+      18,    37,    23,    39,    40,    58,    56,    61,    52,    67,
+      68,    74,    60,     0,    57,    64
 };
 
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int8 yycheck[] =
 {
-     -46,   -46,   -46,   -46,   -46,   -46,   -46,   -46,    21,    40,
-     -46,   -46,    19,   -45,   -46,   -46,   -46,     8
+      46,     3,     3,     3,     3,    15,     0,    17,     3,    11,
+      11,    10,    58,     4,     5,     6,     7,    63,    18,    19,
+      20,     3,    68,     3,     3,    16,     3,     9,    10,     9,
+       9,     3,    14,     3,    14,    14,     3,     3,     3,    11,
+       3,    11,     8,     3,    11,    10,     8,    15,    10,     6,
+       7,     3,     8,    17,     3,    10,    17,    15,     3,     3,
+      10,     3,    47,    -1,    42,    54
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-      58,     4,     5,     6,     7,    39,     3,    20,    43,    21,
-      14,    40,    64,     8,    44,    45,    41,    68,    51,    46,
-      48,    15,    70,    48,    52,    48,    48,    48,    49,    53,
-      43,    65,    61,    69,    71,    72,    26,    45,    24,    62,
-      25,    27,    19,    28,    29,    30,    17,    18,    32,    22,
-      23,    36,    38,    55,    39,    51,    57,    66,    60,    67,
-      73,    63,    56,     0,     0,    59
+       0,    22,    23,     0,     4,     5,     6,     7,    16,    24,
+      26,    27,    31,    36,     3,     3,    30,    30,    30,     3,
+      15,    17,    15,     8,     8,    10,     3,     8,     3,    18,
+      19,    20,    25,     3,    28,    32,    34,     3,    37,    17,
+       3,     9,    14,    29,     3,     9,    10,    14,    33,     3,
+      11,    35,     3,     9,    14,    38,    17,    29,    10,    34,
+      33,    15,     3,    10,    38,    34,    11,     3,    10,    34,
+      11,    34,    11,    11,     3
 };
 
-static const yytype_int8 yycheck[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-      45,     4,     5,     6,     7,     3,     0,    15,     3,    17,
-       3,     9,    57,    16,     9,    10,    14,    62,     3,    14,
-       3,     3,    67,     3,     9,     3,     3,     3,    11,    14,
-       3,    11,     3,    11,    11,    11,     3,    10,     8,    10,
-      10,     8,     3,    18,    19,    20,     6,     7,     3,    15,
-       8,     3,    17,    17,     3,     3,    10,     3,    15,    10,
-       3,    53,    41,    -1,    -1,    46
+       0,    21,    22,    23,    23,    23,    23,    23,    23,    24,
+      25,    25,    25,    25,    26,    26,    27,    28,    28,    28,
+      29,    30,    30,    31,    31,    32,    32,    32,    33,    33,
+      33,    34,    34,    35,    35,    36,    36,    37,    37,    37,
+      38,    38,    38,    38,    38
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
-       0,    22,    23,     0,     4,     5,     6,     7,    16,    24,
-      26,    27,    31,    36,     3,     3,    30,    30,    30,     3,
-      15,    17,    15,     8,     8,    10,     3,     8,    18,    19,
-      20,    25,     3,    28,    32,    34,     3,    37,    17,     3,
-       9,    14,    29,     3,     9,    10,    14,    33,     3,    11,
-      35,     3,     9,    14,    38,    17,    29,    10,    34,    33,
-      15,     3,    10,    38,    34,    11,     3,    10,    34,    11,
-      34,    11,    11,     3
+       0,     2,     1,     0,     2,     2,     2,     2,     2,     2,
+       1,     1,     1,     1,     3,     5,     5,     0,     2,     3,
+       2,     1,     3,     5,     5,     0,     2,     3,     1,     4,
+       3,     0,     2,     1,     3,     4,     5,     0,     2,     3,
+       1,     2,     4,     5,     5
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
 
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#define YYFAIL		goto yyerrlab
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
-
-
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
-
-
-/* YYLEX -- calling `yylex' with the right arguments.  */
-
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -719,80 +750,58 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
-static void
-yy_symbol_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -800,80 +809,68 @@ yy_symbol_print (yyoutput, yytype, yyvaluep)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *bottom, yytype_int16 *top)
-#else
 static void
-yy_stack_print (bottom, top)
-    yytype_int16 *bottom;
-    yytype_int16 *top;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
-  for (; bottom <= top; ++bottom)
-    YYFPRINTF (stderr, " %d", *bottom);
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule)
-#else
 static void
-yy_reduce_print (yyvsp, yyrule)
-    YYSTYPE *yyvsp;
-    int yyrule;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
-      fprintf (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       );
-      fprintf (stderr, "\n");
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -888,478 +885,219 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
 
-#if YYERROR_VERBOSE
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
 
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
-
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
-
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
-    {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
-
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
-
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
-
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
-
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
-    }
-}
-#endif /* YYERROR_VERBOSE */
-
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
-#else
 static void
-yydestruct (yymsg, yytype, yyvaluep)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
-
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-  switch (yytype)
-    {
-
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
-
 
-/* Prevent warnings from -Wmissing-prototypes.  */
 
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
-
-
-
-/* The look-ahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
-/* The semantic value of the look-ahead symbol.  */
+/* The semantic value of the lookahead symbol.  */
 YYSTYPE yylval;
-
 /* Number of syntax errors so far.  */
 int yynerrs;
 
 
 
+
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 int
 yyparse (void)
-#else
-int
-yyparse ()
-
-#endif
-#endif
 {
-  
-  int yystate;
-  int yyn;
-  int yyresult;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
-  /* Look-ahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-  /* Three stacks and their tools:
-     `yyss': related to states,
-     `yyvs': related to semantic values,
-     `yyls': related to locations.
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss = yyssa;
-  yytype_int16 *yyssp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs = yyvsa;
-  YYSTYPE *yyvsp;
-
-
-
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
-
-  YYSIZE_T yystacksize = YYINITDEPTH;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
 
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
-
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-
-  yyssp = yyss;
-  yyvsp = yyvs;
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss);
-	YYSTACK_RELOCATE (yyvs);
-
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
-     look-ahead token if we need one and don't already have one.  */
+     lookahead token if we need one and don't already have one.  */
 
-  /* First try to decide what to do without reference to look-ahead token.  */
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
-  /* Not known => get a look-ahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid look-ahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1374,30 +1112,26 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
   /* Count tokens shifted since error; after three, turn off error
      status.  */
   if (yyerrstatus)
     yyerrstatus--;
 
-  /* Shift the look-ahead token.  */
+  /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1412,14 +1146,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1432,335 +1166,363 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 60 "../code/LangBase/descr.y"
-    { result = new SourceNode(reinterpret_cast<std::vector<DescrNode*>*>((yyvsp[(1) - (1)].vector))); ;}
+  case 2: /* source: nodes  */
+#line 70 "../code/LangBase/descr.y"
+              { result = new SourceNode(reinterpret_cast<std::vector<DescrNode*>*>((yyvsp[0].vector))); }
+#line 1173 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 3:
-#line 63 "../code/LangBase/descr.y"
-    {
+  case 3: /* nodes: %empty  */
+#line 73 "../code/LangBase/descr.y"
+                   {
         (yyval.vector) = new std::vector<DescrNode*>;
-    ;}
+    }
+#line 1181 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 4:
-#line 66 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<DescrNode>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 4: /* nodes: nodes token_decl  */
+#line 76 "../code/LangBase/descr.y"
+                       { (yyval.vector) = push_node<DescrNode>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1187 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 5:
-#line 67 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<DescrNode>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 5: /* nodes: nodes enum_def  */
+#line 77 "../code/LangBase/descr.y"
+                     { (yyval.vector) = push_node<DescrNode>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1193 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 6:
-#line 68 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<DescrNode>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 6: /* nodes: nodes ast  */
+#line 78 "../code/LangBase/descr.y"
+                { (yyval.vector) = push_node<DescrNode>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1199 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 7:
-#line 69 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<DescrNode>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 7: /* nodes: nodes list  */
+#line 79 "../code/LangBase/descr.y"
+                 { (yyval.vector) = push_node<DescrNode>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1205 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 8:
-#line 70 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<DescrNode>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 8: /* nodes: nodes start  */
+#line 80 "../code/LangBase/descr.y"
+                  { (yyval.vector) = push_node<DescrNode>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1211 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 9:
-#line 72 "../code/LangBase/descr.y"
-    { (yyval.ast) = new StartNode((yyvsp[(2) - (2)].sval)); ;}
+  case 9: /* start: START IDENTIFIER  */
+#line 82 "../code/LangBase/descr.y"
+                        { (yyval.ast) = new StartNode((yyvsp[0].sval)); }
+#line 1217 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 10:
-#line 75 "../code/LangBase/descr.y"
-    { (yyval.enm) = TSTRING; ;}
+  case 10: /* tokenType: TOKEN_STRING  */
+#line 85 "../code/LangBase/descr.y"
+                        { (yyval.enm) = TSTRING; }
+#line 1223 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 11:
-#line 76 "../code/LangBase/descr.y"
-    { (yyval.enm) = TINT; ;}
+  case 11: /* tokenType: TOKEN_INT  */
+#line 86 "../code/LangBase/descr.y"
+                    { (yyval.enm) = TINT; }
+#line 1229 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 12:
-#line 77 "../code/LangBase/descr.y"
-    { (yyval.enm) = TFLOAT; ;}
+  case 12: /* tokenType: TOKEN_FLOAT  */
+#line 87 "../code/LangBase/descr.y"
+                      { (yyval.enm) = TFLOAT; }
+#line 1235 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 13:
-#line 80 "../code/LangBase/descr.y"
-    {
-        (yyval.ast) = new TokenNode((yyvsp[(2) - (3)].sval), (yyvsp[(3) - (3)].sval));
-    ;}
+  case 13: /* tokenType: IDENTIFIER  */
+#line 88 "../code/LangBase/descr.y"
+                     { (yyval.enm) = tokenTypeFromName((yyvsp[0].sval)); }
+#line 1241 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 14:
-#line 83 "../code/LangBase/descr.y"
-    {
-        (yyval.ast) = new TokenNode(static_cast<TokenType>((yyvsp[(4) - (5)].enm)), (yyvsp[(2) - (5)].sval), (yyvsp[(5) - (5)].sval));
-    ;}
+  case 14: /* token_decl: TOKEN IDENTIFIER STRING  */
+#line 91 "../code/LangBase/descr.y"
+                                    {
+        (yyval.ast) = new TokenNode((yyvsp[-1].sval), (yyvsp[0].sval));
+    }
+#line 1249 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 15:
-#line 87 "../code/LangBase/descr.y"
-    { 
-      (yyval.ast) = new EnumNode(re<TypeDecl>((yyvsp[(2) - (5)].ast)), reinterpret_cast<std::vector<EnumDeclNode*>*>((yyvsp[(4) - (5)].vector))); 
-    ;}
+  case 15: /* token_decl: TOKEN IDENTIFIER COLON tokenType STRING  */
+#line 94 "../code/LangBase/descr.y"
+                                              {
+        (yyval.ast) = new TokenNode(static_cast<TokenType>((yyvsp[-1].enm)), (yyvsp[-3].sval), (yyvsp[0].sval));
+    }
+#line 1257 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 16:
-#line 90 "../code/LangBase/descr.y"
-    {
+  case 16: /* enum_def: ENUM type_decl LEFT_BRACE enum_decls RIGHT_BRACE  */
+#line 98 "../code/LangBase/descr.y"
+                                                           { 
+      (yyval.ast) = new EnumNode(re<TypeDecl>((yyvsp[-3].ast)), reinterpret_cast<std::vector<EnumDeclNode*>*>((yyvsp[-1].vector))); 
+    }
+#line 1265 "../code/LangBase/gen/descr.tab.cpp"
+    break;
+
+  case 17: /* enum_decls: %empty  */
+#line 101 "../code/LangBase/descr.y"
+                        {
         (yyval.vector) = new std::vector<EnumDeclNode*>;
-    ;}
+    }
+#line 1273 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 17:
-#line 93 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<EnumDeclNode>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 18: /* enum_decls: enum_decls enum_decl  */
+#line 104 "../code/LangBase/descr.y"
+                           { (yyval.vector) = push_node<EnumDeclNode>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1279 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 18:
-#line 94 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<EnumDeclNode>((yyvsp[(1) - (3)].vector), (yyvsp[(3) - (3)].ast)); ;}
+  case 19: /* enum_decls: enum_decls COMMA enum_decl  */
+#line 105 "../code/LangBase/descr.y"
+                                 { (yyval.vector) = push_node<EnumDeclNode>((yyvsp[-2].vector), (yyvsp[0].ast)); }
+#line 1285 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 19:
-#line 96 "../code/LangBase/descr.y"
-    { (yyval.ast) = new EnumDeclNode((yyvsp[(1) - (2)].sval), (yyvsp[(2) - (2)].sval)); ;}
+  case 20: /* enum_decl: IDENTIFIER STRING  */
+#line 107 "../code/LangBase/descr.y"
+                             { (yyval.ast) = new EnumDeclNode((yyvsp[-1].sval), (yyvsp[0].sval)); }
+#line 1291 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 20:
-#line 97 "../code/LangBase/descr.y"
-    { (yyval.ast) = new TypeDecl((yyvsp[(1) - (1)].sval)); ;}
+  case 21: /* type_decl: IDENTIFIER  */
+#line 108 "../code/LangBase/descr.y"
+                      { (yyval.ast) = new TypeDecl((yyvsp[0].sval)); }
+#line 1297 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 21:
-#line 98 "../code/LangBase/descr.y"
-    { (yyval.ast) = new TypeDecl((yyvsp[(3) - (3)].sval), (yyvsp[(1) - (3)].sval)); ;}
+  case 22: /* type_decl: IDENTIFIER COLON IDENTIFIER  */
+#line 109 "../code/LangBase/descr.y"
+                                          { (yyval.ast) = new TypeDecl((yyvsp[0].sval), (yyvsp[-2].sval)); }
+#line 1303 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 22:
-#line 100 "../code/LangBase/descr.y"
-    { 
-        (yyval.ast) = new AstNode(re<TypeDecl>((yyvsp[(2) - (5)].ast)), new std::vector<AstDef*>({new AstDef("", reinterpret_cast<std::vector<AstPart*>*>((yyvsp[(4) - (5)].vector)))}));
-     ;}
+  case 23: /* ast: AST type_decl LEFT_PAREN ast_parts RIGHT_PAREN  */
+#line 111 "../code/LangBase/descr.y"
+                                                    { 
+        (yyval.ast) = new AstNode(re<TypeDecl>((yyvsp[-3].ast)), new std::vector<AstDef*>({new AstDef("", reinterpret_cast<std::vector<AstPart*>*>((yyvsp[-1].vector)))}));
+     }
+#line 1311 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 23:
-#line 103 "../code/LangBase/descr.y"
-    {
-        (yyval.ast) = new AstNode(re<TypeDecl>((yyvsp[(2) - (5)].ast)), reinterpret_cast<std::vector<AstDef*>*>((yyvsp[(4) - (5)].vector)));
-    ;}
+  case 24: /* ast: AST type_decl LEFT_BRACE ast_defs RIGHT_BRACE  */
+#line 114 "../code/LangBase/descr.y"
+                                                    {
+        (yyval.ast) = new AstNode(re<TypeDecl>((yyvsp[-3].ast)), reinterpret_cast<std::vector<AstDef*>*>((yyvsp[-1].vector)));
+    }
+#line 1319 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 24:
-#line 107 "../code/LangBase/descr.y"
-    {
+  case 25: /* ast_defs: %empty  */
+#line 118 "../code/LangBase/descr.y"
+                      {
         (yyval.vector) = new std::vector<AstDef*>;
-    ;}
+    }
+#line 1327 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 25:
-#line 110 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<AstDef>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 26: /* ast_defs: ast_defs ast_def  */
+#line 121 "../code/LangBase/descr.y"
+                       { (yyval.vector) = push_node<AstDef>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1333 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 26:
-#line 111 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<AstDef>((yyvsp[(1) - (3)].vector), (yyvsp[(3) - (3)].ast)); ;}
+  case 27: /* ast_defs: ast_defs COMMA ast_def  */
+#line 122 "../code/LangBase/descr.y"
+                             { (yyval.vector) = push_node<AstDef>((yyvsp[-2].vector), (yyvsp[0].ast)); }
+#line 1339 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 27:
-#line 113 "../code/LangBase/descr.y"
-    { (yyval.ast) = new AstDef((yyvsp[(1) - (1)].sval), new std::vector<AstPart*>); ;}
+  case 28: /* ast_def: IDENTIFIER  */
+#line 124 "../code/LangBase/descr.y"
+                    { (yyval.ast) = new AstDef((yyvsp[0].sval), new std::vector<AstPart*>); }
+#line 1345 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 28:
-#line 114 "../code/LangBase/descr.y"
-    { (yyval.ast) = new AstDef((yyvsp[(1) - (4)].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[(3) - (4)].vector))); ;}
+  case 29: /* ast_def: IDENTIFIER LEFT_PAREN ast_parts RIGHT_PAREN  */
+#line 125 "../code/LangBase/descr.y"
+                                                      { (yyval.ast) = new AstDef((yyvsp[-3].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[-1].vector))); }
+#line 1351 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 29:
-#line 115 "../code/LangBase/descr.y"
-    { (yyval.ast) = new AstDef("", reinterpret_cast<std::vector<AstPart*>*>((yyvsp[(2) - (3)].vector))); ;}
+  case 30: /* ast_def: LEFT_PAREN ast_parts RIGHT_PAREN  */
+#line 126 "../code/LangBase/descr.y"
+                                           { (yyval.ast) = new AstDef("", reinterpret_cast<std::vector<AstPart*>*>((yyvsp[-1].vector))); }
+#line 1357 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 30:
-#line 117 "../code/LangBase/descr.y"
-    {
+  case 31: /* ast_parts: %empty  */
+#line 128 "../code/LangBase/descr.y"
+                       {
         (yyval.vector) = new std::vector<AstPart*>;
-    ;}
+    }
+#line 1365 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 31:
-#line 120 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<AstPart>((yyvsp[(1) - (2)].vector), re<AstPart>((yyvsp[(2) - (2)].ast))); ;}
+  case 32: /* ast_parts: ast_parts ast_part  */
+#line 131 "../code/LangBase/descr.y"
+                         { (yyval.vector) = push_node<AstPart>((yyvsp[-1].vector), re<AstPart>((yyvsp[0].ast))); }
+#line 1371 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 32:
-#line 123 "../code/LangBase/descr.y"
-    { (yyval.ast) = new AstPart((yyvsp[(1) - (1)].sval)); ;}
+  case 33: /* ast_part: IDENTIFIER  */
+#line 134 "../code/LangBase/descr.y"
+                     { (yyval.ast) = new AstPart((yyvsp[0].sval)); }
+#line 1377 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 33:
-#line 124 "../code/LangBase/descr.y"
-    { (yyval.ast) = new AstPart((yyvsp[(3) - (3)].sval), (yyvsp[(1) - (3)].sval)); ;}
+  case 34: /* ast_part: IDENTIFIER COLON IDENTIFIER  */
+#line 135 "../code/LangBase/descr.y"
+                                        { (yyval.ast) = new AstPart((yyvsp[0].sval), (yyvsp[-2].sval)); }
+#line 1383 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 34:
-#line 127 "../code/LangBase/descr.y"
-    { (yyval.ast) = new ListNode(re<TypeDecl>((yyvsp[(2) - (4)].ast)), (yyvsp[(3) - (4)].sval), (yyvsp[(4) - (4)].sval)); ;}
+  case 35: /* list: LIST type_decl IDENTIFIER IDENTIFIER  */
+#line 138 "../code/LangBase/descr.y"
+                                           { (yyval.ast) = new ListNode(re<TypeDecl>((yyvsp[-2].ast)), (yyvsp[-1].sval), (yyvsp[0].sval)); }
+#line 1389 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 35:
-#line 128 "../code/LangBase/descr.y"
-    { 
-        (yyval.ast) = new ListNode(re<TypeDecl>((yyvsp[(2) - (5)].ast)), reinterpret_cast<std::vector<ListDef*>*>((yyvsp[(4) - (5)].vector))); 
-    ;}
+  case 36: /* list: LIST type_decl LEFT_BRACE list_defs RIGHT_BRACE  */
+#line 139 "../code/LangBase/descr.y"
+                                                      { 
+        (yyval.ast) = new ListNode(re<TypeDecl>((yyvsp[-3].ast)), reinterpret_cast<std::vector<ListDef*>*>((yyvsp[-1].vector))); 
+    }
+#line 1397 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 36:
-#line 133 "../code/LangBase/descr.y"
-    {
+  case 37: /* list_defs: %empty  */
+#line 144 "../code/LangBase/descr.y"
+                       {
         (yyval.vector) = new std::vector<ListDef*>;
-    ;}
+    }
+#line 1405 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 37:
-#line 136 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<ListDef>((yyvsp[(1) - (2)].vector), (yyvsp[(2) - (2)].ast)); ;}
+  case 38: /* list_defs: list_defs list_def  */
+#line 147 "../code/LangBase/descr.y"
+                         { (yyval.vector) = push_node<ListDef>((yyvsp[-1].vector), (yyvsp[0].ast)); }
+#line 1411 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 38:
-#line 137 "../code/LangBase/descr.y"
-    { (yyval.vector) = push_node<ListDef>((yyvsp[(1) - (3)].vector), (yyvsp[(3) - (3)].ast)); ;}
+  case 39: /* list_defs: list_defs COMMA list_def  */
+#line 148 "../code/LangBase/descr.y"
+                               { (yyval.vector) = push_node<ListDef>((yyvsp[-2].vector), (yyvsp[0].ast)); }
+#line 1417 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 39:
-#line 139 "../code/LangBase/descr.y"
-    { (yyval.ast) = new ListDef((yyvsp[(1) - (1)].sval), new std::vector<AstPart*>); ;}
+  case 40: /* list_def: IDENTIFIER  */
+#line 150 "../code/LangBase/descr.y"
+                     { (yyval.ast) = new ListDef((yyvsp[0].sval), new std::vector<AstPart*>); }
+#line 1423 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 40:
-#line 140 "../code/LangBase/descr.y"
-    { 
-            (yyval.ast) = new ListDef((yyvsp[(1) - (4)].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[(3) - (4)].vector)));
-        ;}
+  case 41: /* list_def: IDENTIFIER IDENTIFIER  */
+#line 151 "../code/LangBase/descr.y"
+                                { (yyval.ast) = new ListDef((yyvsp[-1].sval), new std::vector<AstPart*>, (yyvsp[0].sval)); }
+#line 1429 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 41:
-#line 143 "../code/LangBase/descr.y"
-    {
-            (yyval.ast) = new ListDef((yyvsp[(1) - (5)].sval), (yyvsp[(2) - (5)].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[(4) - (5)].vector)));
-        ;}
+  case 42: /* list_def: IDENTIFIER LEFT_PAREN ast_parts RIGHT_PAREN  */
+#line 152 "../code/LangBase/descr.y"
+                                                      { 
+            (yyval.ast) = new ListDef((yyvsp[-3].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[-1].vector)));
+        }
+#line 1437 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
-  case 42:
-#line 146 "../code/LangBase/descr.y"
-    { 
-            (yyval.ast) = new ListDef((yyvsp[(1) - (5)].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[(3) - (5)].vector)), (yyvsp[(5) - (5)].sval)); 
-        ;}
+  case 43: /* list_def: IDENTIFIER IDENTIFIER LEFT_PAREN ast_parts RIGHT_PAREN  */
+#line 155 "../code/LangBase/descr.y"
+                                                                 {
+            (yyval.ast) = new ListDef((yyvsp[-4].sval), (yyvsp[-3].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[-1].vector)));
+        }
+#line 1445 "../code/LangBase/gen/descr.tab.cpp"
     break;
 
+  case 44: /* list_def: IDENTIFIER LEFT_PAREN ast_parts RIGHT_PAREN IDENTIFIER  */
+#line 158 "../code/LangBase/descr.y"
+                                                                 { 
+            (yyval.ast) = new ListDef((yyvsp[-4].sval), reinterpret_cast<std::vector<AstPart*>*>((yyvsp[-2].vector)), (yyvsp[0].sval)); 
+        }
+#line 1453 "../code/LangBase/gen/descr.tab.cpp"
+    break;
+
+
+#line 1457 "../code/LangBase/gen/descr.tab.cpp"
 
-/* Line 1267 of yacc.c.  */
-#line 1671 "../code/LangBase/gen/descr.tab.cpp"
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-      {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (yymsg);
-	  }
-	else
-	  {
-	    yyerror (YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
-      }
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
-      /* If just tried and failed to reuse look-ahead token after an
-	 error, discard it.  */
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
     }
 
-  /* Else will try to reuse look-ahead token after shifting the error
+  /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
@@ -1769,14 +1531,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -1789,42 +1550,42 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1835,53 +1596,57 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#ifndef yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
-  if (yychar != YYEOF && yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval);
-  /* Do not reclaim the symbols of the rule which action triggered
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
 
+  return yyresult;
+}
 
-#line 151 "../code/LangBase/descr.y"
+#line 163 "../code/LangBase/descr.y"
 
 
 void yyerror(const char *s) {
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,73 +31,77 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_CODE_LANGBASE_GEN_DESCR_TAB_H_INCLUDED
+# define YY_YY_CODE_LANGBASE_GEN_DESCR_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     IDENTIFIER = 258,
-     TOKEN = 259,
-     ENUM = 260,
-     AST = 261,
-     LIST = 262,
-     LEFT_BRACE = 263,
-     RIGHT_BRACE = 264,
-     LEFT_PAREN = 265,
-     RIGHT_PAREN = 266,
-     LBRACKET = 267,
-     RBRACKET = 268,
-     COMMA = 269,
-     COLON = 270,
-     START = 271,
-     STRING = 272,
-     TOKEN_STRING = 273,
-     TOKEN_INT = 274,
-     TOKEN_FLOAT = 275
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IDENTIFIER = 258,              /* IDENTIFIER  */
+    TOKEN = 259,                   /* TOKEN  */
+    ENUM = 260,                    /* ENUM  */
+    AST = 261,                     /* AST  */
+    LIST = 262,                    /* LIST  */
+    LEFT_BRACE = 263,              /* LEFT_BRACE  */
+    RIGHT_BRACE = 264,             /* RIGHT_BRACE  */
+    LEFT_PAREN = 265,              /* LEFT_PAREN  */
+    RIGHT_PAREN = 266,             /* RIGHT_PAREN  */
+    LBRACKET = 267,                /* LBRACKET  */
+    RBRACKET = 268,                /* RBRACKET  */
+    COMMA = 269,                   /* COMMA  */
+    COLON = 270,                   /* COLON  */
+    START = 271,                   /* START  */
+    STRING = 272,                  /* STRING  */
+    TOKEN_STRING = 273,            /* TOKEN_STRING  */
+    TOKEN_INT = 274,               /* TOKEN_INT  */
+    TOKEN_FLOAT = 275              /* TOKEN_FLOAT  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define IDENTIFIER 258
-#define TOKEN 259
-#define ENUM 260
-#define AST 261
-#define LIST 262
-#define LEFT_BRACE 263
-#define RIGHT_BRACE 264
-#define LEFT_PAREN 265
-#define RIGHT_PAREN 266
-#define LBRACKET 267
-#define RBRACKET 268
-#define COMMA 269
-#define COLON 270
-#define START 271
-#define STRING 272
-#define TOKEN_STRING 273
-#define TOKEN_INT 274
-#define TOKEN_FLOAT 275
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 27 "../code/LangBase/descr.y"
+union YYSTYPE
 {
+#line 37 "../code/LangBase/descr.y"
+
 	int ival;
 	double fval;
 	char *sval;
 	void *ast;
 	void *vector;
 	int enm;
-}
-/* Line 1529 of yacc.c.  */
-#line 98 "../code/LangBase/gen/descr.tab.h"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+
+#line 93 "../code/LangBase/gen/descr.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
+
 extern YYSTYPE yylval;
 
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_CODE_LANGBASE_GEN_DESCR_TAB_H_INCLUDED  */
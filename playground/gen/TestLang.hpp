@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <utility>
 #include <vector>
 enum NodeType {
     AssignNode, ControlStructNode, ExpressionNode, FunctionNode, IdExprNode, IfNode, IntExprNode, StatementNode
@@ -36,7 +37,7 @@ class Assign : public Statement {
 public:
     Expression* expr;
     std::string identifier;
-    Assign(std::string identifier, Expression* expr) : Statement(AssignNode), expr(expr), identifier(identifier) {}
+    Assign(std::string identifier, Expression* expr) : Statement(AssignNode), expr(expr), identifier(std::move(identifier)) {}
 };
 class ControlStruct : public Statement {
 public:
@@ -52,12 +53,12 @@ public:
     std::string identifier;
     std::vector<Statement*>* statements;
     Type type;
-    Function(Type type, std::string identifier, std::vector<Expression*>* argExprs, std::vector<Statement*>* statements) : AstNode(FunctionNode), argExprs(argExprs), identifier(identifier), statements(statements), type(type) {}
+    Function(Type type, std::string identifier, std::vector<Expression*>* argExprs, std::vector<Statement*>* statements) : AstNode(FunctionNode), argExprs(argExprs), identifier(std::move(identifier)), statements(statements), type(type) {}
 };
 class IdExpr : public Expression {
 public:
     std::string identifier;
-    IdExpr(std::string identifier) : Expression(IdExprNode), identifier(identifier) {}
+    IdExpr(std::string identifier) : Expression(IdExprNode), identifier(std::move(identifier)) {}
 };
 class If : public ControlStruct {
 public:
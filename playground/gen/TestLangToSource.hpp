@@ -39,8 +39,9 @@ void TestLangToSource::astKey_expr(Expression *node) {
     }
 }
 void TestLangToSource::listKey_argExprs(std::vector<Expression*> *nodes) {
-    for (Expression* node : *nodes) {
-        if (node != nodes->front()) {
+    for (size_t i = 0; i < nodes->size(); ++i) {
+        Expression* node = (*nodes)[i];
+        if (i > 0) {
             str += ",";
         }
         switch (node->nodeType) {
@@ -54,7 +55,8 @@ void TestLangToSource::listKey_argExprs(std::vector<Expression*> *nodes) {
     }
 }
 void TestLangToSource::listKey_statements(std::vector<Statement*> *nodes) {
-    for (Statement* node : *nodes) {
+    for (size_t i = 0; i < nodes->size(); ++i) {
+        Statement* node = (*nodes)[i];
         switch (node->nodeType) {
             case AssignNode: {
                 visitAssign(static_cast<Assign*>(node));
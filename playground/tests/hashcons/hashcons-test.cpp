@@ -0,0 +1,23 @@
+#include "TestLang.hpp"
+#include "TestLangToSource.hpp"
+#include <string>
+
+using std::string;
+
+// Arguments x and 5 are each one shared node,
+// and must still be separated when rendered
+int main() {
+    string testFile = string(PROJECT_ROOT) + "/playground/tests/hashcons/lang.test";
+    auto result = Loader::parseFile(testFile);
+    auto toSource = TestLangToSource();
+    string source = toSource.render(result);
+    if (source != "void func1(x,x,5,5){myVar=321;}") {
+        printf("Unexpected source: %s\n", source.c_str());
+        return 1;
+    }
+    if (toSource.measure(result) != source.size()) {
+        printf("Measured %zu, rendered %zu\n", toSource.measure(result), source.size());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include <LangBase/Process/SourceGenerator.hpp>
+using namespace LangBase;
+
+int main() {
+    string tests = string(PROJECT_ROOT) + "/playground/tests";
+    // Shared leaves in lists
+    GenOptions hashCons;
+    hashCons.hashCons = true;
+    hashCons.toSourceMeasure = true;
+    SourceGenerator::genFiles(tests + "/hashcons", "TestLang", hashCons);
+    // Reading damaged input
+    GenOptions serializer;
+    serializer.serializer = true;
+    SourceGenerator::genFiles(tests + "/serializer", "TestLang", serializer);
+    // Edits keeping trivia
+    GenOptions lossless;
+    lossless.lossless = true;
+    SourceGenerator::genFiles(tests + "/lossless", "TestLang", lossless);
+    // Masks of path copies
+    GenOptions persistent;
+    persistent.persistentNodes = true;
+    persistent.subtreeMask = true;
+    SourceGenerator::genFiles(tests + "/persistent", "TestLang", persistent);
+    // Snapshot images, spilled items and copies
+    GenOptions snapshot;
+    snapshot.snapshot = true;
+    snapshot.spill = true;
+    snapshot.cloneTree = true;
+    SourceGenerator::genFiles(tests + "/snapshot", "TestLang", snapshot);
+    return 0;
+}
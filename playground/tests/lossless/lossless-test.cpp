@@ -0,0 +1,45 @@
+#include "TestLang.hpp"
+#include "TestLangToSource.hpp"
+#include <string>
+
+using std::string;
+
+static string render(Function *function, SyntaxTree *syntax) {
+    auto toSource = TestLangToSource();
+    toSource.syntax = syntax;
+    toSource.visitFunction(function);
+    return toSource.str;
+}
+
+static bool expect(string source, const char *expected) {
+    if (source != expected) {
+        printf("Unexpected source: %s\n", source.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Edits keep the trivia of the source, both
+// around edited nodes and inside them
+int main() {
+    string testFile = string(PROJECT_ROOT) + "/playground/tests/lossless/lang.test";
+    auto result = Loader::parseFile(testFile);
+    SyntaxTree syntax = std::move(syntaxTree);
+    if (!expect(render(result, &syntax), syntax.text.c_str())) return 1;
+    Assign *first = static_cast<Assign*>((*result->statements)[0]);
+    Assign *second = static_cast<Assign*>((*result->statements)[1]);
+    first->identifier = "renamed";
+    first->markEdited();
+    second->expr = new IdExpr("z");
+    second->expr->parent = second;
+    second->markEdited();
+    if (!expect(render(result, &syntax),
+                " void  func1( 123 ,  x ) {\n    renamed   =  321 ;\n    other = z;\n}\n")) return 1;
+    result->identifier = "func2";
+    result->markEdited();
+    if (!expect(render(result, &syntax),
+                " void  func2( 123 ,  x ) {\n    renamed   =  321 ;\n    other = z;\n}\n")) return 1;
+    // Without source, as from the ast
+    if (!expect(render(result, nullptr), "void func2(123,x){renamed=321;other=z;}")) return 1;
+    return 0;
+}
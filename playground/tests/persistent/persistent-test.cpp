@@ -0,0 +1,35 @@
+#include "TestLang.hpp"
+#include "TestLangToSource.hpp"
+#include <string>
+
+using std::string;
+
+// Copies along a path get the masks of their
+// new subtrees, originals keep theirs
+int main() {
+    IdExpr *id = finishNode(new IdExpr("y"));
+    Assign *assign = finishNode(new Assign("x", id));
+    Function *function = finishNode(new Function(VOID, "func1",
+        new std::vector<Expression*>(), new std::vector<Statement*>{assign}));
+    std::vector<AstNode*> path;
+    if (!findPath(function, id, path)) {
+        printf("Path not found\n");
+        return 1;
+    }
+    Function *changed = static_cast<Function*>(withPath(path, finishNode(new IntExpr(1))));
+    if (!subtreeHas(changed, nodeMask(IntExprNode)) || subtreeHas(changed, nodeMask(IdExprNode))) {
+        printf("Copied root has a stale mask\n");
+        return 1;
+    }
+    if (subtreeHas(function, nodeMask(IntExprNode)) || !subtreeHas(function, nodeMask(IdExprNode))) {
+        printf("Original root mask changed\n");
+        return 1;
+    }
+    auto toSource = TestLangToSource();
+    toSource.visitFunction(changed);
+    if (toSource.str != "void func1(){x=1;}") {
+        printf("Unexpected source: %s\n", toSource.str.c_str());
+        return 1;
+    }
+    return 0;
+}
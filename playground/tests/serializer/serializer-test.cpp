@@ -0,0 +1,64 @@
+#include "TestLang.hpp"
+#include "TestLangToSource.hpp"
+#include "TestLangSerializer.hpp"
+#include <string>
+
+using std::string;
+
+static string render(Function *function) {
+    auto toSource = TestLangToSource();
+    toSource.visitFunction(function);
+    return toSource.str;
+}
+
+static Function* makeFunction(std::vector<Expression*> *argExprs, std::vector<Statement*> *statements) {
+    return new Function(VOID, "func1", argExprs, statements);
+}
+
+// Deserializing is expected to fail, leaving nothing behind
+static bool rejects(Function *function, const char *what) {
+    string bin = TestLangSerializer::serialize(function);
+    destroyTree(function);
+    if (TestLangDeserializer::deserialize(bin.data(), bin.size()) != nullptr) {
+        printf("Accepted %s\n", what);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    Function *function = makeFunction(
+        new std::vector<Expression*>{new IntExpr(1), new IdExpr("x")},
+        new std::vector<Statement*>{new Assign("a", new IntExpr(2)), new If(new IdExpr("a"))});
+    string bin = TestLangSerializer::serialize(function);
+    Function *back = TestLangDeserializer::deserialize(bin.data(), bin.size());
+    if (back == nullptr || render(back) != render(function)) {
+        printf("Round trip failed\n");
+        return 1;
+    }
+    destroyTree(back);
+    // Every truncation fails
+    for (size_t len = 0; len < bin.size(); ++len) {
+        if (TestLangDeserializer::deserialize(bin.data(), len) != nullptr) {
+            printf("Accepted %zu of %zu bytes\n", len, bin.size());
+            return 1;
+        }
+    }
+    destroyTree(function);
+    // Statement in place of an expression
+    Assign *swapped = new Assign("b", new IntExpr(3));
+    bool ok = rejects(makeFunction(
+        new std::vector<Expression*>{reinterpret_cast<Expression*>(swapped)},
+        new std::vector<Statement*>()), "statement in expression list");
+    ok = rejects(makeFunction(
+        new std::vector<Expression*>(),
+        new std::vector<Statement*>{new If(reinterpret_cast<Expression*>(new Assign("c", new IntExpr(4))))}),
+        "statement as if condition") && ok;
+    ok = rejects(makeFunction(
+        new std::vector<Expression*>{new IntExpr(5), nullptr},
+        new std::vector<Statement*>()), "null list element") && ok;
+    ok = rejects(makeFunction(
+        new std::vector<Expression*>(),
+        new std::vector<Statement*>{new Assign("d", nullptr)}), "null required child") && ok;
+    return ok ? 0 : 1;
+}
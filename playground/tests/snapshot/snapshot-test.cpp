@@ -0,0 +1,110 @@
+#include "TestLang.hpp"
+#include "TestLangToSource.hpp"
+#include "TestLangSnapshot.hpp"
+#include <string>
+
+using std::string;
+
+static string render(Function *function) {
+    auto toSource = TestLangToSource();
+    toSource.visitFunction(function);
+    return toSource.str;
+}
+
+static bool fail(const char *what) {
+    printf("%s\n", what);
+    return false;
+}
+
+// Records are 4 byte aligned within the image
+static bool aligned(const TestLangSnapshot &snap, SnapNode node) {
+    return (node.rec - snap.data) % 4 == 0;
+}
+
+// Fields read through the views match the tree
+static bool checkViews(const TestLangSnapshot &snap) {
+    SnapFunction function(snap.root());
+    if (function.nodeType() != FunctionNode || !aligned(snap, function)) return fail("Bad root");
+    if (function.identifier().str() != "func1" || function.type() != VOID) return fail("Bad function fields");
+    SnapList args = function.argExprs();
+    if (args.size() != 2 || SnapIntExpr(args[0]).intConst() != 7 || SnapIdExpr(args[1]).identifier().str() != "x") {
+        return fail("Bad arguments");
+    }
+    SnapList statements = function.statements();
+    if (statements.size() != 3) return fail("Bad statement count");
+    SnapAssign first(statements[0]);
+    if (first.nodeType() != AssignNode || first.identifier().str() != "a" || SnapIntExpr(first.expr()).intConst() != -5) {
+        return fail("Bad first statement");
+    }
+    SnapAssign second(statements[1]);
+    if (!aligned(snap, second) || SnapIdExpr(second.expr()).identifier().str() != "a") return fail("Bad second statement");
+    SnapIf third(statements[2]);
+    if (third.nodeType() != IfNode || third.expr().nodeType() != IdExprNode) return fail("Bad third statement");
+    return true;
+}
+
+static bool testSnapshot(Function *function) {
+    TestLangSnapshotWriter writer;
+    if (!writer.write(function)) return fail("Write failed");
+    TestLangSnapshot snap;
+    if (!snap.openMemory(writer.image.data(), writer.image.size()) || !checkViews(snap)) return false;
+    // Header checks
+    if (snap.openMemory(writer.image.data(), 15)) return fail("Accepted truncated header");
+    string image = writer.image;
+    image[8] ^= 1;
+    if (snap.openMemory(image.data(), image.size())) return fail("Accepted other grammar");
+    image = writer.image;
+    image[0] = 'X';
+    if (snap.openMemory(image.data(), image.size())) return fail("Accepted bad magic");
+    // Through a mapped file
+    string fileName = string(PROJECT_ROOT) + "/playground/tests/snapshot/test.snap";
+    if (!TestLangSnapshotWriter::saveFile(function, fileName)) return fail("Save failed");
+    TestLangSnapshot mapped;
+    bool ok = mapped.open(fileName) && checkViews(mapped);
+    mapped.close();
+    remove(fileName.c_str());
+    return ok || fail("Mapped snapshot differs");
+}
+
+// Every spilled item reads back as parsed
+static bool testSpill() {
+    string testFile = string(PROJECT_ROOT) + "/playground/tests/snapshot/lang.test";
+    Function *parsed = Loader::parseFile(testFile);
+    TestLangSpillStore store;
+    Function *spilled = Loader::parseFile(testFile, &store);
+    if (!store.open()) return fail("Spill open failed");
+    bool ok = spilled->statements->size() == parsed->statements->size();
+    for (size_t i = 0; ok && i < parsed->statements->size(); ++i) {
+        Assign *assign = static_cast<Assign*>((*parsed->statements)[i]);
+        SnapAssign item(store.item(spilled->statements, i));
+        ok = (*spilled->statements)[i] == nullptr && !item.isNull() && item.nodeType() == AssignNode
+            && item.identifier().str() == assign->identifier && item.expr().nodeType() == assign->expr->nodeType;
+    }
+    destroyTree(parsed);
+    destroyTree(spilled);
+    return ok || fail("Spilled item differs");
+}
+
+static bool testClone(Function *function) {
+    bool ok;
+    {
+        NodeArena arena;
+        Function *copy = clone(function, arena);
+        ok = copy != function && (*copy->statements)[0] != (*function->statements)[0]
+            && render(copy) == render(function);
+    }
+    HeapAllocator heap;
+    Function *copy = clone(function, heap);
+    ok = ok && render(copy) == render(function);
+    destroyTree(copy);
+    return ok || fail("Clone differs");
+}
+
+int main() {
+    Function *function = new Function(VOID, "func1",
+        new std::vector<Expression*>{new IntExpr(7), new IdExpr("x")},
+        new std::vector<Statement*>{new Assign("a", new IntExpr(-5)), new Assign("b", new IdExpr("a")), new If(new IdExpr("a"))});
+    bool ok = testSnapshot(function) && testSpill() && testClone(function);
+    destroyTree(function);
+    return ok ? 0 : 1;
+}